@@ -1,14 +1,23 @@
 #pragma once
 
 #include "implementation/concurrent_queue.hpp"
+#include "implementation/edit_script.hpp"
 #include "implementation/levenshtein_penalty_functions.hpp"
+#include "implementation/levenshtein_session.hpp"
 #include "implementation/locking.hpp"
+#include "implementation/query_profile.hpp"
+#include "implementation/radix_trie.hpp"
+#include "implementation/resumable_query.hpp"
+#include "implementation/segmentation_search.hpp"
 #include "implementation/trie.hpp"
+#include "implementation/trie_search.hpp"
 #include "implementation/vectorized_trie.hpp"
 #include "utils/statistics_collector.hpp"
 
+#include <atomic>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <queue>
 #include <string>
 #include <thread>
@@ -22,8 +31,10 @@ struct TriePayload {
 
 // set early break to true to skip sub-trees that cannot be better that the
 // current best
+// set transpositions to true to let query() charge swapped adjacent characters with penalty.transpose
+// with a RadixTrie (EdgeTrie), only query() is supported, the other queries do not compile
 template <class PenaltyClass = levenshtein::KBDistance, class ParallelTrieImpl = VectorizedParallelTrie<TriePayload>,
-          bool early_break = true, bool collect_stats = false>
+          bool early_break = true, bool collect_stats = false, bool transpositions = false>
 class AcceleratedLevenshtein {
 
   private:
@@ -34,26 +45,6 @@ class AcceleratedLevenshtein {
     AcceleratedLevenshtein(PenaltyClass penalty, std::size_t num_threads = std::thread::hardware_concurrency())
         : penalty(penalty), num_threads(num_threads), trie(num_threads) {}
 
-    std::size_t compute_number_children(NodePtrType ptr) {
-        ChildPtrIteratorType it;
-        ChildPtrIteratorType end;
-
-        std::tie(it, end) = trie.get_child_iterator(ptr);
-
-        if (it == end)
-            return trie.get_payload(ptr).num_children = 0;
-
-        std::size_t count = 0;
-
-        for (; it != end; it++) {
-            count += compute_number_children(trie.dereference_child_iterator(it)) + 1;
-        }
-
-        trie.get_payload(ptr).num_children = count;
-
-        return count;
-    }
-
     void precompute(std::vector<std::string>& words) noexcept {
         if constexpr (collect_stats) {
             statistics_collector::get().start_measure("insert");
@@ -69,7 +60,7 @@ class AcceleratedLevenshtein {
             if constexpr (collect_stats) {
                 statistics_collector::get().start_measure("compute_children");
             }
-            compute_number_children(trie.get_root());
+            count_subtrees(trie, num_threads);
             if constexpr (collect_stats) {
                 statistics_collector::get().stop_measure();
             }
@@ -108,209 +99,344 @@ class AcceleratedLevenshtein {
         }
     }
 
-    inline bool has_children(NodePtrType node) {
-        auto iters = trie.get_child_iterator(node);
-        return iters.first != iters.second;
+    // calculate_children for tries with character runs on the edges (RadixTrie): the rows of a run are computed in a
+    // tight loop and only the row at the end of the edge is kept in dp. As the row minimum never decreases along a
+    // path, the run stops as soon as a row exceeds bound, the child is then skipped by the search.
+    inline void calculate_children_runs(const NodePtrType& node, const std::string& query, const float bound) {
+
+        const std::size_t row_size = query.size() + 1;
+        const float* parent_row = &dp[trie.get_index(node) * row_size];
+
+        // rows inside a run
+        thread_local std::vector<float> scratch;
+        scratch.resize(2 * row_size);
+
+        ChildPtrIteratorType it;
+        ChildPtrIteratorType end;
+        std::tie(it, end) = trie.get_child_iterator(node);
+
+        for (; it != end; it++) {
+            NodePtrType child = trie.dereference_child_iterator(it);
+
+            const auto [run, length] = trie.get_edge(child);
+            float* child_row = &dp[trie.get_index(child) * row_size];
+
+            const float* previous_row = parent_row;
+            float min = 0;
+            std::size_t r = 0;
+            for (; r < length; r++) {
+                float* row = r + 1 == length ? child_row : &scratch[(r % 2) * row_size];
+                min = calculate_row(previous_row, row, run[r], query);
+                previous_row = row;
+
+                if constexpr (early_break) {
+                    if (min > bound)
+                        break;
+                }
+            }
+
+            // a pruned leaf is not a result either
+            trie.get_payload(child).min_distance = min;
+            trie.get_payload(child).distance =
+                r == length ? child_row[query.size()] : std::numeric_limits<float>().max();
+        }
     }
 
-    std::vector<std::pair<float, std::string>> query(const std::string& query, const std::size_t n) noexcept {
-        // Prepare
+    // calculate_children with transpositions (optimal string alignment): a child may also align the last two
+    // characters of its path swapped, which reads the row of its grandparent. That row is still in dp, as every node
+    // keeps its row, so the extra term costs one comparison per cell and no additional storage.
+    //
+    // The row of a child no longer bounds its sub-tree, as the grandchildren may skip it through a transposition.
+    // They can only do so at the columns after a query character that equals the character of the child, so the
+    // bound also takes the minimum of the row of node at these columns.
+    inline void calculate_children_transpose(const NodePtrType& node, const std::string& query) {
 
-        if constexpr (collect_stats) {
-            statistics_collector::get().add_stat("num_nodes", std::to_string(trie.get_num_nodes()));
+        const std::size_t current_index_shift = trie.get_index(node) * (query.size() + 1);
+
+        // the children of the root have no grandparent
+        const bool has_grandparent = node != trie.get_root();
+        const float* grandparent_row =
+            has_grandparent ? &dp[trie.get_index(trie.get_parent(node)) * (query.size() + 1)] : nullptr;
+        const char parent_character = has_grandparent ? trie.get_character(node) : '\0';
+
+        ChildPtrIteratorType it;
+        ChildPtrIteratorType end;
+        std::tie(it, end) = trie.get_child_iterator(node);
+
+        for (; it != end; it++) {
+            NodePtrType child = trie.dereference_child_iterator(it);
+
+            const char character = trie.get_character(child);
+            const float insert_penalty = penalty.insert(character);
+            const float transpose_penalty = has_grandparent ? penalty.transpose(parent_character, character) : 0.f;
+            const std::size_t child_index_shift = trie.get_index(child) * (query.size() + 1);
+
+            float min = dp[child_index_shift] = dp[current_index_shift] + insert_penalty;
+
+            for (std::size_t i = 1; i <= query.size(); i++) {
+                float value = std::min(std::min(dp[current_index_shift + i] + insert_penalty,
+                                                dp[child_index_shift + i - 1] + penalty.remove(query[i - 1])),
+                                       dp[current_index_shift + i - 1] + penalty.modify(character, query[i - 1]));
+
+                if (i > 1) {
+                    if (has_grandparent && character == query[i - 2] && parent_character == query[i - 1])
+                        value = std::min(value, grandparent_row[i - 2] + transpose_penalty);
+
+                    // a child of child may swap with character here
+                    if constexpr (early_break) {
+                        if (character == query[i - 1])
+                            min = std::min(min, dp[current_index_shift + i - 2]);
+                    }
+                }
+
+                dp[child_index_shift + i] = value;
+                if constexpr (early_break)
+                    min = std::min(min, value);
+            }
+
+            trie.get_payload(child).min_distance = min;
+            trie.get_payload(child).distance = dp[child_index_shift + query.size()];
         }
-        std::size_t skipped_nodes = 0;
+    }
+
+    // Prefix (autocomplete) variant of calculate_children: the score of a node is the best alignment of the full
+    // query against the path to any of its ancestors (including itself), plus completion_penalty for each character
+    // that follows the aligned prefix. distance holds the score, min_distance bounds the scores below the node.
+    inline void calculate_children_prefix(const NodePtrType& node, const std::string& query,
+                                          const float completion_penalty) {
 
-        std::queue<NodePtrType> task_queue;
-        std::mutex global_task_queue_mtx;
-        const std::size_t query_size = query.size();
+        const std::size_t current_index_shift = trie.get_index(node) * (query.size() + 1);
+        const float completed_distance = trie.get_payload(node).distance + completion_penalty;
 
-        dp.resize(trie.get_num_nodes() * (query_size + 1));
+        ChildPtrIteratorType it;
+        ChildPtrIteratorType end;
+        std::tie(it, end) = trie.get_child_iterator(node);
 
-        dp[0] = 0;
-        early_break_min_max.store(std::numeric_limits<float>().max(), std::memory_order_relaxed);
+        for (; it != end; it++) {
+            NodePtrType child = trie.dereference_child_iterator(it);
 
-        for (std::size_t i = 1; i <= query_size; i++) {
-            dp[i] = dp[i - 1] + penalty.remove(query[i - 1]);
+            const char character = trie.get_character(child);
+            const float insert_penalty = penalty.insert(character);
+            const std::size_t child_index_shift = trie.get_index(child) * (query.size() + 1);
+
+            float min = dp[child_index_shift] = dp[current_index_shift] + insert_penalty;
+
+            for (std::size_t i = 1; i <= query.size(); i++) {
+                dp[child_index_shift + i] =
+                    std::min(std::min(dp[current_index_shift + i] + insert_penalty,
+                                      dp[child_index_shift + i - 1] + penalty.remove(query[i - 1])),
+                             dp[current_index_shift + i - 1] + penalty.modify(character, query[i - 1]));
+                if constexpr (early_break)
+                    min = std::min(min, dp[child_index_shift + i]);
+            }
+
+            const float distance = std::min(completed_distance, dp[child_index_shift + query.size()]);
+
+            // descendants can only improve on the score by aligning the query with a longer prefix
+            trie.get_payload(child).min_distance = std::min(min, distance);
+            trie.get_payload(child).distance = distance;
         }
+    }
+
+    // calculate_children with the per column costs of a query profile instead of a query string
+    inline void calculate_children_profile(const NodePtrType& node, const QueryProfile& profile) {
 
-        calculate_children(trie.get_root(), query);
+        const std::size_t current_index_shift = trie.get_index(node) * (profile.size + 1);
 
-        ChildPtrIteratorType begin;
+        ChildPtrIteratorType it;
         ChildPtrIteratorType end;
-        std::tie(begin, end) = trie.get_child_iterator(trie.get_root());
-        for (ChildPtrIteratorType it = begin; it != end; it++) {
-            task_queue.push(trie.dereference_child_iterator(it));
+        std::tie(it, end) = trie.get_child_iterator(node);
+
+        for (; it != end; it++) {
+            NodePtrType child = trie.dereference_child_iterator(it);
+
+            const char character = trie.get_character(child);
+            const float insert_penalty = penalty.insert(character);
+            const std::size_t child_index_shift = trie.get_index(child) * (profile.size + 1);
+            const float* modify = &profile.modify[static_cast<std::size_t>(character) * profile.size];
+
+            float min = dp[child_index_shift] = dp[current_index_shift] + insert_penalty;
+
+            for (std::size_t i = 1; i <= profile.size; i++) {
+                dp[child_index_shift + i] =
+                    std::min(std::min(dp[current_index_shift + i] + insert_penalty * profile.insert_scale[i - 1],
+                                      dp[child_index_shift + i - 1] + profile.remove[i - 1]),
+                             dp[current_index_shift + i - 1] + modify[i - 1]);
+                if constexpr (early_break)
+                    min = std::min(min, dp[child_index_shift + i]);
+            }
+
+            trie.get_payload(child).min_distance = min;
+            trie.get_payload(child).distance = dp[child_index_shift + profile.size];
         }
+    }
 
-        // Parallel execution
-
-        std::mutex global_queue_mtx;
-        std::priority_queue<std::pair<float, NodePtrType>> q;
-        std::vector<std::thread> threads;
-        struct alignas(CACHE_LINE_SIZE / 2) Signal {
-            Signal() : other_needes_work(false) {}
-            std::atomic<bool> other_needes_work;
-        };
-        Signal signals[num_threads];
-        std::atomic<std::size_t> global_missing(trie.get_num_nodes() - 1);
-
-        for (unsigned int t = 0; t < num_threads; t++) {
-            threads.emplace_back([&, t]() {
-                std::priority_queue<std::pair<float, NodePtrType>> local_q;
-                std::queue<NodePtrType> local_task_queue;
-
-                // Work from Queue until all nodes are processed
-                NodePtrType current;
-                std::size_t local_done = 0;
-                ChildPtrIteratorType it;
-                ChildPtrIteratorType end;
-                float global_min_max = early_break_min_max.load(std::memory_order_relaxed);
-                std::size_t local_skipped = 0;
-
-                while (true) {
-                    global_task_queue_mtx.lock();
-                    if (!task_queue.empty()) {
-
-                        local_task_queue.push(task_queue.front());
-                        task_queue.pop();
-
-                        global_task_queue_mtx.unlock();
-
-                        // got work
-                        do {
-                            current = local_task_queue.front();
-                            local_task_queue.pop();
-
-                            calculate_children(current, query);
-                            local_done++;
-
-                            // Fill Task-Queue and update current
-                            std::tie(it, end) = trie.get_child_iterator(current);
-
-                            // Check the local minimum only once for all
-                            // children
-                            if constexpr (early_break) {
-                                if (local_q.size() >= n) {
-                                    global_min_max = early_break_min_max.load(std::memory_order_relaxed);
-
-                                    if (local_q.top().first < global_min_max) {
-                                        early_break_min_max.store(local_q.top().first, std::memory_order_relaxed);
-                                        global_min_max = local_q.top().first;
-                                    }
-                                }
-                            }
-
-                            // Add children to work and result queue
-                            for (; it != end; it++) {
-                                NodePtrType child = trie.dereference_child_iterator(it);
-
-                                // Work -> Local Queue
-                                if (trie.is_leaf(child)) {
-                                    if (local_q.size() < n ||
-                                        trie.get_payload(child).distance < local_q.top().first) { // order matters here
-                                        local_q.emplace(trie.get_payload(child).distance, child);
-                                        if (local_q.size() > n)
-                                            local_q.pop();
-                                    }
-                                }
-
-                                // Test if we should check out children of
-                                // children
-                                if constexpr (early_break) {
-                                    // Do not explore if it can only get worse
-                                    if (local_q.size() >= n) {
-                                        if (trie.get_payload(child).min_distance >
-                                            std::min(global_min_max, local_q.top().first)) {
-                                            local_done += trie.get_payload(child).num_children + 1;
-
-                                            if constexpr (collect_stats) {
-                                                local_skipped += trie.get_payload(child).num_children + 1;
-                                            }
-
-                                        } else if (has_children(child)) {
-                                            // We keep one child locally
-                                            local_task_queue.push(child);
-                                        } else {
-                                            // does not have children, skip
-                                            // queuing
-                                            local_done++;
-                                        }
-                                    } else {
-                                        local_task_queue.push(child);
-                                    }
-                                } else {
-                                    local_task_queue.push(child);
-                                }
-                            }
-
-                            const std::size_t size = local_task_queue.size();
-                            if (size > 1000 && signals[t].other_needes_work.load(std::memory_order_relaxed)) {
-                                global_task_queue_mtx.lock();
-
-                                for (std::size_t i = 0; i < size / 2; i++) {
-                                    task_queue.push(local_task_queue.front());
-                                    local_task_queue.pop();
-                                }
-
-                                // std::cout << task_queue.size() << std::endl;
-                                global_task_queue_mtx.unlock();
-                                signals[t].other_needes_work.store(false, std::memory_order_relaxed);
-                            }
-                        } while (!local_task_queue.empty());
-
-                    } else { // global queue is empty
-                        global_task_queue_mtx.unlock();
-                        // update done counter and check if thread should stop
-                        if (local_done) {
-                            std::size_t missing =
-                                global_missing.fetch_sub(local_done, std::memory_order_relaxed) - local_done;
-
-                            if (missing <= 0) {
-                                break;
-                            }
-                            local_done = 0;
-                        } else if (global_missing.load(std::memory_order_relaxed) <= 0) {
-                            break;
-                        }
-
-                        signals[(t + 1) % num_threads].other_needes_work.store(true, std::memory_order_relaxed);
-                    }
-                }
+    // Once *cancelled is set, the query returns early with an incomplete result.
+    std::vector<std::pair<float, std::string>> query(const std::string& query, const std::size_t n,
+                                                     const std::atomic<bool>* cancelled = nullptr) noexcept {
+        prepare_root(query);
 
-                // Local Queue -> Global Queue
-                global_queue_mtx.lock();
-                while (!local_q.empty()) {
-                    std::pair<float, NodePtrType> entry = std::move(local_q.top());
-                    local_q.pop();
+        static_assert(!(transpositions && EdgeTrie<ParallelTrieImpl>), "transpositions need a character per node");
 
-                    if (q.size() < n || entry.first < q.top().first) { // order matters here
-                        q.push(entry);
-                        if (q.size() > n)
-                            q.pop();
-                    }
-                }
-                skipped_nodes += local_skipped;
-                global_queue_mtx.unlock();
-                //-------------------------------
-            });
+        if constexpr (EdgeTrie<ParallelTrieImpl>) {
+            return to_words(search_trie<ParallelTrieImpl, early_break, collect_stats>(
+                trie, n, num_threads,
+                [&](const NodePtrType& node, const float bound) { calculate_children_runs(node, query, bound); },
+                cancelled));
+        }
+
+        if constexpr (transpositions) {
+            return to_words(search_trie<ParallelTrieImpl, early_break, collect_stats>(
+                trie, n, num_threads, [&](const NodePtrType& node) { calculate_children_transpose(node, query); },
+                cancelled));
+        }
+
+        return to_words(search_trie<ParallelTrieImpl, early_break, collect_stats>(
+            trie, n, num_threads, [&](const NodePtrType& node) { calculate_children(node, query); }, cancelled));
+    }
+
+    // Autocomplete query: query only has to match a prefix of the word. Words are scored by the best alignment of
+    // query against one of their prefixes, plus completion_penalty per remaining character of the word. With
+    // completion_penalty = 0, all completions of a matching prefix share the same score.
+    std::vector<std::pair<float, std::string>> query_prefix(const std::string& query, const std::size_t n,
+                                                            const float completion_penalty = 0.f) noexcept {
+        static_assert(!EdgeTrie<ParallelTrieImpl>, "query_prefix needs a character per node");
+        prepare_root(query);
+        trie.get_payload(trie.get_root()).distance = dp[query.size()];
+
+        return to_words(search_trie<ParallelTrieImpl, early_break, collect_stats>(
+            trie, n, num_threads,
+            [&](const NodePtrType& node) { calculate_children_prefix(node, query, completion_penalty); }));
+    }
+
+    // Compound query: the best decompositions of query into up to max_words dictionary words, returned as the words
+    // joined by spaces ("Hausboot" -> "Haus boot"). Every additional word costs split_penalty, a space in the query
+    // is free between two words. The dp restarts at the root from the row of a leaf, so one search covers all splits.
+    std::vector<std::pair<float, std::string>> query_segmented(const std::string& query, const std::size_t n,
+                                                               const std::size_t max_words = 2,
+                                                               const float split_penalty = 0.f) noexcept {
+        static_assert(!EdgeTrie<ParallelTrieImpl>, "query_segmented needs a character per node");
+        return SegmentationSearch<PenaltyClass, ParallelTrieImpl>(trie, penalty, query, max_words, split_penalty,
+                                                                  num_threads)
+            .run(n);
+    }
+
+    // number of leading characters of query that form a path in the trie
+    std::size_t matching_prefix_length(const std::string& query) {
+        static_assert(!EdgeTrie<ParallelTrieImpl>, "matching_prefix_length needs a character per node");
+        NodePtrType current = trie.get_root();
+
+        for (std::size_t i = 0; i < query.size(); i++) {
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType end;
+            std::tie(it, end) = trie.get_child_iterator(current);
+
+            while (it != end && trie.get_character(trie.dereference_child_iterator(it)) != query[i])
+                it++;
+
+            if (it == end)
+                return i;
+
+            current = trie.dereference_child_iterator(it);
         }
 
-        // Wait for threads to finish execution
-        for (auto& thread : threads)
-            thread.join();
+        return query.size();
+    }
+
+    // Best-first variant of query() that can be continued: handle.next(k) returns the next k results and keeps the
+    // unexplored frontier for the following call. The handle shares the trie, so it is invalidated by precompute().
+    ResumableQuery<PenaltyClass, ParallelTrieImpl> resumable_query(const std::string& query) noexcept {
+        static_assert(!EdgeTrie<ParallelTrieImpl>, "resumable_query needs a character per node");
+        return ResumableQuery<PenaltyClass, ParallelTrieImpl>(trie, penalty, query, num_threads);
+    }
+
+    // Incremental query for typed input: push_char()/pop_char() only update the nodes within max_cost of the typed
+    // prefix. The session shares the trie, so it is invalidated by precompute().
+    LevenshteinSession<PenaltyClass, ParallelTrieImpl> session(const float max_cost) noexcept {
+        static_assert(!EdgeTrie<ParallelTrieImpl>, "session needs a character per node");
+        return LevenshteinSession<PenaltyClass, ParallelTrieImpl>(trie, penalty, max_cost);
+    }
 
-        // Queue -> Result vector
-        std::vector<std::pair<float, std::string>> result(q.size());
-        while (!q.empty()) {
-            result[q.size() - 1] = std::make_pair(q.top().first, trie.get_word(q.top().second));
-            q.pop();
+    // Query for ambiguous input: every position of the lattice lists the characters the user may have meant, each
+    // with an additional cost. A position costs the cheapest of its alternatives, so a single traversal scores the
+    // words against all strings of the lattice. See levenshtein::keyboard_lattice to derive a lattice from taps.
+    std::vector<std::pair<float, std::string>> query_lattice(const levenshtein::KeystrokeLattice& lattice,
+                                                             const std::size_t n) noexcept {
+        static_assert(!EdgeTrie<ParallelTrieImpl>, "query_lattice needs a character per node");
+        return query_profile(QueryProfile::from_lattice(penalty, lattice), n);
+    }
+
+    // Pattern query: '?' matches any single character and '*' any run of characters at no cost, e.g. "alg?rith*".
+    // The wildcards are evaluated inside the trie dp, so sub-trees are pruned like in query().
+    std::vector<std::pair<float, std::string>> query_pattern(const std::string& pattern, const std::size_t n) noexcept {
+        static_assert(!EdgeTrie<ParallelTrieImpl>, "query_pattern needs a character per node");
+        return query_profile(QueryProfile::from_pattern(penalty, pattern), n);
+    }
+
+    std::vector<std::pair<float, std::string>> query_profile(const QueryProfile& profile,
+                                                             const std::size_t n) noexcept {
+        static_assert(!EdgeTrie<ParallelTrieImpl>, "query_profile needs a character per node");
+        dp.resize(trie.get_num_nodes() * (profile.size + 1));
+
+        dp[0] = 0;
+        for (std::size_t i = 1; i <= profile.size; i++) {
+            dp[i] = dp[i - 1] + profile.remove[i - 1];
         }
 
-        if constexpr (collect_stats) {
-            statistics_collector::get().add_stat("skipped_nodes", std::to_string(skipped_nodes));
+        return to_words(search_trie<ParallelTrieImpl, early_break, collect_stats>(
+            trie, n, num_threads, [&](const NodePtrType& node) { calculate_children_profile(node, profile); }));
+    }
+
+    // The edits that turn word into query at its distance. The dp of query() keeps no traceback, the alignment is
+    // computed again in linear space.
+    levenshtein::EditScript explain(const std::string& query, const std::string& word) const {
+        return levenshtein::explain(penalty, query, word);
+    }
+
+    // explain() for all words of a result, in parallel
+    std::vector<levenshtein::EditScript> explain(const std::string& query,
+                                                 const std::vector<std::pair<float, std::string>>& result) const {
+        std::vector<levenshtein::EditScript> scripts(result.size());
+
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+        for (std::size_t i = 0; i < result.size(); i++) {
+            scripts[i] = explain(query, result[i].second);
+        }
+
+        return scripts;
+    }
+
+  private:
+    // returns the minimum of the new row
+    inline float calculate_row(const float* parent_row, float* row, const char character, const std::string& query) {
+        const float insert_penalty = penalty.insert(character);
+
+        float min = row[0] = parent_row[0] + insert_penalty;
+
+        for (std::size_t i = 1; i <= query.size(); i++) {
+            row[i] = std::min(std::min(parent_row[i] + insert_penalty, row[i - 1] + penalty.remove(query[i - 1])),
+                              parent_row[i - 1] + penalty.modify(character, query[i - 1]));
+            min = std::min(min, row[i]);
         }
 
+        return min;
+    }
+
+    // dp row of the root: the query is removed character by character
+    void prepare_root(const std::string& query) {
+        dp.resize(trie.get_num_nodes() * (query.size() + 1));
+
+        dp[0] = 0;
+        for (std::size_t i = 1; i <= query.size(); i++) {
+            dp[i] = dp[i - 1] + penalty.remove(query[i - 1]);
+        }
+    }
+
+    std::vector<std::pair<float, std::string>> to_words(const std::vector<std::pair<float, NodePtrType>>& nodes) {
+        std::vector<std::pair<float, std::string>> result(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            result[i] = std::make_pair(nodes[i].first, trie.get_word(nodes[i].second));
+        }
         return result;
     }
 
@@ -319,6 +445,4 @@ class AcceleratedLevenshtein {
     alignas(CACHE_LINE_SIZE) const std::size_t num_threads;
     alignas(CACHE_LINE_SIZE) ParallelTrieImpl trie;
     alignas(CACHE_LINE_SIZE) std::vector<float> dp;
-    // the smallest of all largest elements in queues
-    alignas(CACHE_LINE_SIZE) std::atomic<float> early_break_min_max;
 };
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace utf8 {
+
+// Code point of the sequence at position, which is advanced past it. Bytes that do not start a valid sequence are
+// taken as Latin-1 characters, so dictionaries in Latin-1 are read as well.
+inline char32_t next_code_point(const std::string& text, std::size_t& position) {
+    const auto byte = [&](std::size_t i) { return static_cast<unsigned char>(text[i]); };
+    const unsigned char lead = byte(position);
+
+    std::size_t length = 0;
+    char32_t code_point = lead;
+    if (lead >= 0xc2 && lead < 0xe0) {
+        length = 2;
+        code_point = lead & 0x1f;
+    } else if (lead >= 0xe0 && lead < 0xf0) {
+        length = 3;
+        code_point = lead & 0x0f;
+    } else if (lead >= 0xf0 && lead < 0xf5) {
+        length = 4;
+        code_point = lead & 0x07;
+    }
+
+    if (length == 0 || position + length > text.size()) {
+        position++;
+        return lead;
+    }
+
+    for (std::size_t i = 1; i < length; i++) {
+        if ((byte(position + i) & 0xc0) != 0x80) {
+            position++;
+            return lead;
+        }
+        code_point = (code_point << 6) | (byte(position + i) & 0x3f);
+    }
+
+    position += length;
+    return code_point;
+}
+
+inline void append(std::string& text, char32_t code_point) {
+    if (code_point < 0x80) {
+        text.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        text.push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+    } else if (code_point < 0x10000) {
+        text.push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+    } else {
+        text.push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+    }
+}
+
+// ASCII letter of a Latin-1 letter without its diacritic ('ä' -> 'a', 'ß' -> 's'), the code point itself if it is
+// ASCII and '\0' if there is none
+inline char fold(char32_t code_point) {
+    static constexpr char LATIN_1[] = "AAAAAAACEEEEIIIIDNOOOOO\0OUUUUYTsaaaaaaaceeeeiiiidnooooo\0ouuuuyty";
+
+    if (code_point < 0x80)
+        return static_cast<char>(code_point);
+    if (code_point >= 0xc0 && code_point <= 0xff)
+        return LATIN_1[code_point - 0xc0];
+    return '\0';
+}
+
+} // namespace utf8
+
+// Dense symbols for the code points of a dictionary. The code points that occur are numbered from 1 in the order of
+// their frequency, and words are encoded as strings of these symbols, one char per code point. The tries and the
+// penalties then see symbols 1 to size() instead of UTF-8 bytes, so a character with diacritics is one node instead
+// of two and the symbols in use are the first of the range. Query code points that are not in the dictionary are
+// encoded as get_unknown(), which matches no dictionary symbol. At most 126 distinct code points fit into the char
+// range of the tries, the constructor throws std::length_error for more.
+class Alphabet {
+
+  public:
+    static constexpr std::size_t MAX_SIZE = 126;
+
+  public:
+    Alphabet() = default;
+
+    explicit Alphabet(const std::vector<std::string>& words) {
+        std::unordered_map<char32_t, std::size_t> counts;
+        for (const std::string& word : words) {
+            for (std::size_t position = 0; position < word.size();)
+                counts[utf8::next_code_point(word, position)]++;
+        }
+
+        std::vector<std::pair<std::size_t, char32_t>> by_frequency;
+        for (const auto& [code_point, count] : counts)
+            by_frequency.emplace_back(count, code_point);
+        std::sort(by_frequency.begin(), by_frequency.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+
+        if (by_frequency.size() > MAX_SIZE)
+            throw std::length_error("the words have " + std::to_string(by_frequency.size()) +
+                                    " distinct code points, an Alphabet holds at most " +
+                                    std::to_string(MAX_SIZE));
+
+        // symbol 0 is not used, the strings of the tries end there
+        code_points.assign(1, 0);
+        for (const auto& [count, code_point] : by_frequency) {
+            const char symbol = static_cast<char>(code_points.size());
+            code_points.push_back(code_point);
+            if (code_point < 0x80)
+                ascii_symbols[code_point] = symbol;
+            else
+                other_symbols.emplace(code_point, symbol);
+        }
+    }
+
+    // number of symbols of the dictionary
+    std::size_t size() const {
+        return code_points.size() - 1;
+    }
+
+    char get_unknown() const {
+        return static_cast<char>(code_points.size());
+    }
+
+    // code point of symbol, 0 for get_unknown()
+    char32_t get_code_point(char symbol) const {
+        const auto index = static_cast<std::size_t>(static_cast<unsigned char>(symbol));
+        return index < code_points.size() ? code_points[index] : 0;
+    }
+
+    char get_symbol(char32_t code_point) const {
+        if (code_point < 0x80)
+            return ascii_symbols[code_point] ? ascii_symbols[code_point] : get_unknown();
+
+        auto it = other_symbols.find(code_point);
+        return it == other_symbols.end() ? get_unknown() : it->second;
+    }
+
+    std::string encode(const std::string& text) const {
+        std::string symbols;
+        symbols.reserve(text.size());
+        for (std::size_t position = 0; position < text.size();)
+            symbols.push_back(get_symbol(utf8::next_code_point(text, position)));
+        return symbols;
+    }
+
+    // UTF-8 of the symbols
+    std::string decode(const std::string& symbols) const {
+        std::string text;
+        text.reserve(symbols.size());
+        for (const char symbol : symbols)
+            utf8::append(text, get_code_point(symbol));
+        return text;
+    }
+
+  private:
+    // code_points[symbol]
+    std::vector<char32_t> code_points = {0};
+    // symbol of an ASCII code point, 0 if it does not occur
+    std::array<char, 128> ascii_symbols{};
+    std::unordered_map<char32_t, char> other_symbols;
+};
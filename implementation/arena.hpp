@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator for objects that live as long as the arena. Objects are carved out of blocks that double in size
+// up to MAX_BLOCK_SIZE and are released all at once when the arena is destroyed, without calling destructors, so
+// only trivially destructible types are accepted. An arena is not thread safe, concurrent code uses one per thread.
+class Arena {
+
+  private:
+    static constexpr std::size_t MIN_BLOCK_SIZE = std::size_t(1) << 12;
+    static constexpr std::size_t MAX_BLOCK_SIZE = std::size_t(1) << 20;
+
+  public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) = default;
+    Arena& operator=(Arena&&) = default;
+
+    template <class T, class... Args> T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "the arena does not call destructors");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // default constructed array of count elements
+    template <class T> T* make_array(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "the arena does not call destructors");
+        return new (allocate(sizeof(T) * count, alignof(T))) T[count]();
+    }
+
+    void* allocate(std::size_t size, std::size_t alignment) {
+        if (blocks.empty() || aligned_offset(used, alignment) + size > block_size) {
+            block_size = std::max(size + alignment,
+                                  std::min(MAX_BLOCK_SIZE, blocks.empty() ? MIN_BLOCK_SIZE : 2 * block_size));
+            blocks.emplace_back(new std::byte[block_size]);
+            reserved += block_size;
+            used = 0;
+        }
+
+        const std::size_t offset = aligned_offset(used, alignment);
+        used = offset + size;
+        return blocks.back().get() + offset;
+    }
+
+    // bytes of all blocks
+    std::size_t get_reserved() const {
+        return reserved;
+    }
+
+  private:
+    // first aligned offset at or after from in the last block
+    std::size_t aligned_offset(std::size_t from, std::size_t alignment) const {
+        const std::size_t address = reinterpret_cast<std::size_t>(blocks.back().get()) + from;
+        return from + (((address + alignment - 1) & ~(alignment - 1)) - address);
+    }
+
+  private:
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::size_t block_size = 0;
+    // bytes used of the last block
+    std::size_t used = 0;
+    std::size_t reserved = 0;
+};
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "implementation/dawg.hpp"
+#include "implementation/levenshtein_penalty_functions.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace levenshtein {
+
+// Universal Levenshtein automaton for unit costs and distances up to max_distance (k). A state is the band of a dp
+// row i around the diagonal, the cells of the query prefixes i - k to i + k, with every distance above k clipped to
+// k + 1 (dead). The next row only depends on the band and on which query characters of the band equal the next
+// character (the characteristic vector), not on the query itself, so the transitions of all states under all 2^(2k +
+// 1) vectors are computed once per k and shared by all queries. Cells before the start of the query are dead, the
+// cells after its end are set dead by truncate after each step.
+template <std::size_t max_distance> class UniversalAutomaton {
+
+    static_assert(max_distance <= 3, "the transition table has 2^(2k + 1) entries per state");
+
+  public:
+    using StateType = std::uint32_t;
+    static constexpr std::size_t WIDTH = 2 * max_distance + 1;
+    static constexpr std::uint8_t DEAD = max_distance + 1;
+    // all cells dead
+    static constexpr StateType DEAD_STATE = 0;
+
+  public:
+    // built on first use
+    static const UniversalAutomaton& get() {
+        static const UniversalAutomaton automaton;
+        return automaton;
+    }
+
+    // row 0 of a query of query_size characters
+    StateType initial(std::size_t query_size) const {
+        return truncate(INITIAL_STATE, query_size + max_distance + 1);
+    }
+
+    // bit t of characteristic: the query character of cell t of the next row, i - k + t, equals the text character
+    StateType step(StateType state, std::uint32_t characteristic) const {
+        return transitions[(static_cast<std::size_t>(state) << WIDTH) | characteristic];
+    }
+
+    // the cells from valid on are dead
+    StateType truncate(StateType state, std::size_t valid) const {
+        return valid >= WIDTH ? state : truncations[state * WIDTH + valid];
+    }
+
+    std::uint8_t get_cell(StateType state, std::size_t cell) const {
+        return cells[state * WIDTH + cell];
+    }
+
+    // smallest distance of the band, no word below a state can be closer
+    std::uint8_t get_min(StateType state) const {
+        return mins[state];
+    }
+
+    std::size_t get_num_states() const {
+        return mins.size();
+    }
+
+  private:
+    using Cells = std::array<std::uint8_t, WIDTH>;
+
+    static constexpr StateType INITIAL_STATE = 1;
+
+    // the reachable states, breadth first from the dead and the initial band
+    UniversalAutomaton() {
+        std::unordered_map<std::uint32_t, StateType> ids;
+        std::vector<Cells> states;
+
+        auto find_or_add = [&](const Cells& band) {
+            std::uint32_t key = 0;
+            for (std::uint8_t cell : band)
+                key = key * (DEAD + 1) + cell;
+
+            const auto [it, inserted] = ids.emplace(key, static_cast<StateType>(states.size()));
+            if (inserted)
+                states.push_back(band);
+            return it->second;
+        };
+
+        Cells dead;
+        dead.fill(DEAD);
+        find_or_add(dead);
+
+        // row 0: the distance of query prefix j is j, there are no cells before the query
+        Cells initial;
+        for (std::size_t cell = 0; cell < WIDTH; cell++)
+            initial[cell] = cell < max_distance ? DEAD : static_cast<std::uint8_t>(cell - max_distance);
+        find_or_add(initial);
+
+        for (StateType state = 0; state < states.size(); state++) {
+            const Cells band = states[state];
+
+            for (std::uint32_t characteristic = 0; characteristic < (1u << WIDTH); characteristic++) {
+                // substitution or match from the left cell of the previous row (same cell of the band), deletion
+                // from the cell above (next cell of the band), insertion from the left cell of the new row
+                Cells next;
+                std::uint8_t left = DEAD;
+                for (std::size_t cell = 0; cell < WIDTH; cell++) {
+                    const std::uint8_t diagonal = band[cell] + !((characteristic >> cell) & 1);
+                    const std::uint8_t above = cell + 1 < WIDTH ? band[cell + 1] + 1 : DEAD;
+                    next[cell] = std::min({diagonal, above, static_cast<std::uint8_t>(left + 1), DEAD});
+                    left = next[cell];
+                }
+                transitions.push_back(find_or_add(next));
+            }
+
+            for (std::size_t valid = 0; valid < WIDTH; valid++) {
+                Cells truncated = band;
+                std::fill(truncated.begin() + valid, truncated.end(), DEAD);
+                truncations.push_back(find_or_add(truncated));
+            }
+        }
+
+        for (const Cells& band : states) {
+            cells.insert(cells.end(), band.begin(), band.end());
+            mins.push_back(*std::min_element(band.begin(), band.end()));
+        }
+    }
+
+  private:
+    // [state << WIDTH | characteristic]
+    std::vector<StateType> transitions;
+    // [state * WIDTH + valid]
+    std::vector<StateType> truncations;
+    std::vector<std::uint8_t> cells;
+    std::vector<std::uint8_t> mins;
+};
+
+} // namespace levenshtein
+
+// Unit cost engine on a minimized DAWG (Dawg) that only finds the words within max_distance edits of the query. The
+// dp rows are replaced by states of the universal Levenshtein automaton, a depth first search keeps one per level
+// of the current path, so a query needs memory in the length of the words instead of in the size of the dictionary.
+// The subtrees are pruned once the band has no distance below the n-th best word found.
+template <std::size_t max_distance = 2, bool collect_stats = false> class AutomatonLevenshtein {
+
+  private:
+    using Automaton = levenshtein::UniversalAutomaton<max_distance>;
+    using AutomatonStateType = typename Automaton::StateType;
+    using DawgStateType = typename Dawg<collect_stats>::StateType;
+
+  public:
+    AutomatonLevenshtein(levenshtein::UnitPenalty = {}, std::size_t num_threads = std::thread::hardware_concurrency())
+        : dawg(num_threads) {}
+
+    void precompute(std::vector<std::string>& words) noexcept {
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("insert");
+        }
+        dawg.insert(words);
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+        }
+
+        Automaton::get();
+    }
+
+    // the n closest words within max_distance, sorted by distance
+    std::vector<std::pair<float, std::string>> query(const std::string& query, const std::size_t n) noexcept {
+        if (n == 0)
+            return {};
+
+        const Automaton& automaton = Automaton::get();
+        const std::size_t query_size = query.size();
+        prepare_characteristics(query);
+
+        // largest distance kept, a word must be closer once there are n
+        std::priority_queue<std::pair<float, std::string>> best;
+        auto bound = [&]() { return best.size() < n ? Automaton::DEAD : best.top().first; };
+
+        // the distance of the whole query is cell query_size - depth + k
+        auto distance = [&](AutomatonStateType state, std::size_t depth) {
+            const std::size_t cell = query_size + max_distance - depth;
+            return depth <= query_size + max_distance && cell < Automaton::WIDTH ? automaton.get_cell(state, cell)
+                                                                                  : Automaton::DEAD;
+        };
+
+        std::string path;
+        std::vector<Frame> stack;
+
+        const AutomatonStateType initial = automaton.initial(query_size);
+        if (dawg.is_final(dawg.get_root()) && distance(initial, 0) < bound())
+            best.emplace(distance(initial, 0), "");
+        stack.push_back({dawg.get_root(), initial, dawg.get_edges(dawg.get_root())});
+
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            if (frame.edges.first == frame.edges.second) {
+                stack.pop_back();
+                if (!path.empty())
+                    path.pop_back();
+                continue;
+            }
+
+            const std::size_t edge = frame.edges.first++;
+            const std::size_t depth = stack.size() - 1;
+            const char character = dawg.get_character(edge);
+
+            // the cells of the next row up to the end of the query
+            const std::size_t valid = query_size + max_distance >= depth ? query_size + max_distance - depth : 0;
+            const AutomatonStateType state =
+                automaton.truncate(automaton.step(frame.automaton_state, characteristic(character, depth)), valid);
+
+            if (automaton.get_min(state) >= bound())
+                continue;
+
+            const DawgStateType target = dawg.get_target(edge);
+            path.push_back(character);
+
+            if (dawg.is_final(target)) {
+                const float word_distance = distance(state, depth + 1);
+                if (word_distance < bound()) {
+                    best.emplace(word_distance, path);
+                    if (best.size() > n)
+                        best.pop();
+                }
+            }
+
+            stack.push_back({target, state, dawg.get_edges(target)});
+        }
+
+        std::vector<std::pair<float, std::string>> result(best.size());
+        for (std::size_t i = result.size(); i-- > 0;) {
+            result[i] = best.top();
+            best.pop();
+        }
+        return result;
+    }
+
+    std::size_t get_max_distance() const {
+        return max_distance;
+    }
+
+  private:
+    struct Frame {
+        DawgStateType dawg_state;
+        AutomatonStateType automaton_state;
+        // transitions not searched yet
+        std::pair<std::size_t, std::size_t> edges;
+    };
+
+    // bit j + k of the mask of c is set if query[j] == c, so the characteristic vector of row i is at bit i
+    void prepare_characteristics(const std::string& query) {
+        mask_words = (query.size() + 3 * max_distance + 1) / 64 + 2;
+        masks.assign(256 * mask_words, 0);
+        for (std::size_t j = 0; j < query.size(); j++) {
+            const std::size_t position = j + max_distance;
+            masks[static_cast<unsigned char>(query[j]) * mask_words + position / 64] |= std::uint64_t(1)
+                                                                                         << (position % 64);
+        }
+    }
+
+    std::uint32_t characteristic(const char c, const std::size_t row) const {
+        const std::uint64_t* mask = &masks[static_cast<unsigned char>(c) * mask_words + row / 64];
+        std::uint64_t bits = mask[0] >> (row % 64);
+        if (row % 64)
+            bits |= mask[1] << (64 - row % 64);
+        return static_cast<std::uint32_t>(bits & ((std::uint64_t(1) << Automaton::WIDTH) - 1));
+    }
+
+  private:
+    Dawg<collect_stats> dawg;
+    std::vector<std::uint64_t> masks;
+    std::size_t mask_words = 0;
+};
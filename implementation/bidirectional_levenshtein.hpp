@@ -0,0 +1,136 @@
+#pragma once
+
+#include "implementation/accelerated_levenshtein.hpp"
+#include "implementation/levenshtein_penalty_functions.hpp"
+#include "implementation/sequential_levenshtein.hpp"
+#include "implementation/vectorized_trie.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class SearchDirection {
+    // run the forward and the backward search concurrently (half of the threads each), both are exact, so the first
+    // to finish cancels the other and returns its results
+    BOTH,
+    // search the direction whose trie matches the longer part of the query before the first error
+    HEURISTIC
+};
+
+// Levenshtein search on the words and on the reversed words. Early break prunes poorly while the query has an
+// error within the first characters, as all top level sub-trees look equally bad. Aligning the reversed query with
+// the reversed words yields the same distances, but the error is now at the end of the path.
+template <class PenaltyClass = levenshtein::KBDistance, class ParallelTrieImpl = VectorizedParallelTrie<TriePayload>,
+          bool early_break = true, bool collect_stats = false>
+    requires(!EdgeTrie<ParallelTrieImpl>)
+class BidirectionalLevenshtein {
+
+  private:
+    // the engines run concurrently, the statistics collector is not thread safe
+    using EngineType = AcceleratedLevenshtein<PenaltyClass, ParallelTrieImpl, early_break, false>;
+
+  public:
+    BidirectionalLevenshtein(PenaltyClass penalty, std::size_t num_threads = std::thread::hardware_concurrency(),
+                             SearchDirection direction = SearchDirection::HEURISTIC)
+        : direction(direction), forward(penalty, engine_threads(num_threads, direction)),
+          backward(penalty, engine_threads(num_threads, direction)), rescore(penalty) {}
+
+    void precompute(std::vector<std::string>& words) noexcept {
+        std::vector<std::string> reversed_words(words.size());
+        for (std::size_t i = 0; i < words.size(); i++) {
+            reversed_words[i] = reversed(words[i]);
+        }
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("forward");
+        }
+        forward.precompute(words);
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+            statistics_collector::get().start_measure("backward");
+        }
+        backward.precompute(reversed_words);
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+        }
+    }
+
+    std::vector<std::pair<float, std::string>> query(const std::string& query, const std::size_t n) noexcept {
+        const std::string reversed_query = reversed(query);
+
+        if (direction == SearchDirection::HEURISTIC) {
+            // the error is probably further away from the end that matches more characters
+            if (backward.matching_prefix_length(reversed_query) > forward.matching_prefix_length(query)) {
+                if constexpr (collect_stats) {
+                    statistics_collector::get().add_stat("direction", "backward");
+                }
+                return rescored(query, reversed_results(backward.query(reversed_query, n)));
+            }
+
+            if constexpr (collect_stats) {
+                statistics_collector::get().add_stat("direction", "forward");
+            }
+            return forward.query(query, n);
+        }
+
+        // the search that sets finished first was not cancelled, its results are complete
+        std::atomic<bool> finished(false);
+        std::vector<std::pair<float, std::string>> result;
+        bool backward_first = false;
+
+        std::thread backward_thread([&]() {
+            std::vector<std::pair<float, std::string>> backward_result = backward.query(reversed_query, n, &finished);
+            if (!finished.exchange(true)) {
+                result = rescored(query, reversed_results(std::move(backward_result)));
+                backward_first = true;
+            }
+        });
+        std::vector<std::pair<float, std::string>> forward_result = forward.query(query, n, &finished);
+        if (!finished.exchange(true))
+            result = std::move(forward_result);
+        backward_thread.join();
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().add_stat("direction", backward_first ? "backward" : "forward");
+        }
+        return result;
+    }
+
+  private:
+    static std::size_t engine_threads(std::size_t num_threads, SearchDirection direction) {
+        return direction == SearchDirection::BOTH ? std::max<std::size_t>(1, num_threads / 2) : num_threads;
+    }
+
+    static std::string reversed(const std::string& word) {
+        return std::string(word.rbegin(), word.rend());
+    }
+
+    static std::vector<std::pair<float, std::string>>
+    reversed_results(std::vector<std::pair<float, std::string>> result) {
+        for (auto& entry : result) {
+            std::reverse(entry.second.begin(), entry.second.end());
+        }
+        return result;
+    }
+
+    // Both searches are exact, but the backward dp sums up the costs in a different order. The backward results are
+    // scored again in forward direction, so equal distances stay equal and the order matches the forward engine.
+    std::vector<std::pair<float, std::string>> rescored(const std::string& query,
+                                                        std::vector<std::pair<float, std::string>> backward_result) {
+        for (auto& entry : backward_result) {
+            entry.first = rescore.edit_distance(entry.second, query);
+        }
+        std::sort(backward_result.begin(), backward_result.end());
+
+        return backward_result;
+    }
+
+  private:
+    const SearchDirection direction;
+    EngineType forward;
+    EngineType backward;
+    SequentialLevenshtein<PenaltyClass> rescore;
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "implementation/accelerated_levenshtein.hpp"
+#include "implementation/levenshtein_penalty_functions.hpp"
+#include "implementation/radix_trie.hpp"
+#include "implementation/trie.hpp"
+#include "implementation/trie_search.hpp"
+#include "implementation/vectorized_trie.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace levenshtein {
+
+using BitVector = std::uint64_t;
+constexpr std::size_t BIT_VECTOR_SIZE = 64;
+
+// Myers' column step on one block of the pattern (global alignment, formulated as in edlib). The column is stored
+// as vertical deltas: bit i of vp (vn) is set if cell i + 1 is one larger (smaller) than cell i. eq has the bits of
+// the pattern positions that match the next text character. hin is the horizontal delta of the cell above the
+// block, the horizontal delta of the last cell of the block is returned.
+inline int advance_block(BitVector& vp, BitVector& vn, BitVector eq, const int hin) {
+    const BitVector hin_negative = hin < 0 ? 1 : 0;
+    const BitVector xv = eq | vn;
+    eq |= hin_negative;
+    const BitVector xh = (((eq & vp) + vp) ^ vp) | eq;
+
+    BitVector ph = vn | ~(xh | vp);
+    BitVector mh = vp & xh;
+
+    int hout = static_cast<int>(ph >> (BIT_VECTOR_SIZE - 1)) - static_cast<int>(mh >> (BIT_VECTOR_SIZE - 1));
+
+    ph = (ph << 1) | (hin > 0 ? 1 : 0);
+    mh = (mh << 1) | hin_negative;
+
+    vp = mh | ~(xv | ph);
+    vn = ph & xv;
+
+    return hout;
+}
+
+// sum of the vertical deltas, i.e. last cell - first cell of the column
+inline int column_sum(const BitVector* vp, const BitVector* vn, const std::size_t blocks, const BitVector last_mask) {
+    int sum = 0;
+    for (std::size_t b = 0; b + 1 < blocks; b++) {
+        sum += std::popcount(vp[b]) - std::popcount(vn[b]);
+    }
+    if (blocks > 0) {
+        sum += std::popcount(vp[blocks - 1] & last_mask) - std::popcount(vn[blocks - 1] & last_mask);
+    }
+    return sum;
+}
+
+// smallest prefix sum of the vertical deltas (at most 0), i.e. smallest cell - first cell of the column
+inline int column_min(const BitVector* vp, const BitVector* vn, const std::size_t blocks, const BitVector last_mask) {
+    // per 4 deltas (vp nibble, vn nibble): their sum and smallest prefix sum
+    static const std::array<std::pair<std::int8_t, std::int8_t>, 256> nibbles = []() {
+        std::array<std::pair<std::int8_t, std::int8_t>, 256> table;
+        for (int p = 0; p < 16; p++) {
+            for (int n = 0; n < 16; n++) {
+                int sum = 0;
+                int min = 0;
+                for (int i = 0; i < 4; i++) {
+                    sum += ((p >> i) & 1) - ((n >> i) & 1);
+                    min = std::min(min, sum);
+                }
+                table[p * 16 + n] = {static_cast<std::int8_t>(sum), static_cast<std::int8_t>(min)};
+            }
+        }
+        return table;
+    }();
+
+    int sum = 0;
+    int min = 0;
+    for (std::size_t b = 0; b < blocks; b++) {
+        BitVector p = vp[b];
+        BitVector n = vn[b];
+        if (b + 1 == blocks) {
+            p &= last_mask;
+            n &= last_mask;
+        }
+
+        // only vp can increase the sum, the minimum is reached before the last vn
+        for (; n; p >>= 4, n >>= 4) {
+            const auto& [nibble_sum, nibble_min] = nibbles[(p & 15) * 16 + (n & 15)];
+            min = std::min(min, sum + nibble_min);
+            sum += nibble_sum;
+        }
+        sum += std::popcount(p);
+    }
+    return min;
+}
+
+// Match masks of a pattern, split into blocks of BIT_VECTOR_SIZE positions
+struct BitParallelPattern {
+    explicit BitParallelPattern(const std::string& pattern)
+        : size(pattern.size()), blocks((pattern.size() + BIT_VECTOR_SIZE - 1) / BIT_VECTOR_SIZE),
+          last_mask(size % BIT_VECTOR_SIZE ? (BitVector(1) << (size % BIT_VECTOR_SIZE)) - 1 : ~BitVector(0)),
+          peq(256 * blocks, 0) {
+        for (std::size_t i = 0; i < size; i++) {
+            const std::size_t block = static_cast<unsigned char>(pattern[i]) * blocks + i / BIT_VECTOR_SIZE;
+            peq[block] |= BitVector(1) << (i % BIT_VECTOR_SIZE);
+        }
+    }
+
+    const BitVector* get_peq(const char c) const {
+        return &peq[static_cast<unsigned char>(c) * blocks];
+    }
+
+    // Levenshtein distance of text and the pattern
+    std::size_t distance(const std::string& text) const {
+        if (blocks == 1) {
+            BitVector vp = ~BitVector(0);
+            BitVector vn = 0;
+            for (const char c : text) {
+                advance_block(vp, vn, *get_peq(c), 1);
+            }
+            return text.size() + column_sum(&vp, &vn, 1, last_mask);
+        }
+
+        std::vector<BitVector> vp(blocks, ~BitVector(0));
+        std::vector<BitVector> vn(blocks, 0);
+        for (const char c : text) {
+            const BitVector* eq = get_peq(c);
+            int hin = 1;
+            for (std::size_t b = 0; b < blocks; b++) {
+                hin = advance_block(vp[b], vn[b], eq[b], hin);
+            }
+        }
+        return text.size() + column_sum(vp.data(), vn.data(), blocks, last_mask);
+    }
+
+    std::size_t size;
+    std::size_t blocks;
+    BitVector last_mask;
+    // peq[c * blocks + b]: positions of c in block b
+    std::vector<BitVector> peq;
+};
+
+} // namespace levenshtein
+
+// AcceleratedLevenshtein for unit costs (levenshtein::UnitPenalty). The dp row of a node is stored as Myers' delta
+// bit-vectors over the query, so a child costs a few word operations per 64 query characters instead of a float
+// dp over every character. Queries up to 64 characters fit into a single word. A node advances the vectors by one
+// character, so tries with edge runs (RadixTrie) are not accepted.
+template <class ParallelTrieImpl = VectorizedParallelTrie<TriePayload>, bool early_break = true,
+          bool collect_stats = false>
+    requires(!EdgeTrie<ParallelTrieImpl>)
+class BitParallelLevenshtein {
+
+  private:
+    using NodePtrType = typename ParallelTrieImpl::NodePtrType;
+    using ChildPtrIteratorType = typename ParallelTrieImpl::ChildPtrIteratorType;
+    using BitVector = levenshtein::BitVector;
+
+  public:
+    BitParallelLevenshtein(levenshtein::UnitPenalty = {}, std::size_t num_threads = std::thread::hardware_concurrency())
+        : num_threads(num_threads), trie(num_threads) {}
+
+    void precompute(std::vector<std::string>& words) noexcept {
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("insert");
+        }
+        trie.insert(words);
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+        }
+
+        if constexpr (early_break) {
+            if constexpr (collect_stats) {
+                statistics_collector::get().start_measure("compute_children");
+            }
+            count_subtrees(trie, num_threads);
+            if constexpr (collect_stats) {
+                statistics_collector::get().stop_measure();
+            }
+        }
+    }
+
+    inline void calculate_children(const NodePtrType& node, const levenshtein::BitParallelPattern& pattern) {
+        const std::size_t blocks = pattern.blocks;
+        const std::size_t current_index = trie.get_index(node);
+
+        ChildPtrIteratorType it;
+        ChildPtrIteratorType end;
+        std::tie(it, end) = trie.get_child_iterator(node);
+
+        for (; it != end; it++) {
+            NodePtrType child = trie.dereference_child_iterator(it);
+
+            const std::size_t child_index = trie.get_index(child);
+            const BitVector* eq = pattern.get_peq(trie.get_character(child));
+            BitVector* vp = &vps[child_index * blocks];
+            BitVector* vn = &vns[child_index * blocks];
+
+            // the first cell is the depth of the node
+            depths[child_index] = depths[current_index] + 1;
+
+            int hin = 1;
+            for (std::size_t b = 0; b < blocks; b++) {
+                vp[b] = vps[current_index * blocks + b];
+                vn[b] = vns[current_index * blocks + b];
+                hin = levenshtein::advance_block(vp[b], vn[b], eq[b], hin);
+            }
+
+            const float depth = static_cast<float>(depths[child_index]);
+            trie.get_payload(child).distance = depth + levenshtein::column_sum(vp, vn, blocks, pattern.last_mask);
+            if constexpr (early_break)
+                trie.get_payload(child).min_distance =
+                    depth + levenshtein::column_min(vp, vn, blocks, pattern.last_mask);
+        }
+    }
+
+    std::vector<std::pair<float, std::string>> query(const std::string& query, const std::size_t n) noexcept {
+        const levenshtein::BitParallelPattern pattern(query);
+
+        // root: the query is removed character by character
+        const std::size_t root_index = trie.get_index(trie.get_root());
+        vps.resize(trie.get_num_nodes() * pattern.blocks);
+        vns.resize(trie.get_num_nodes() * pattern.blocks);
+        depths.resize(trie.get_num_nodes());
+
+        std::fill_n(&vps[root_index * pattern.blocks], pattern.blocks, ~BitVector(0));
+        std::fill_n(&vns[root_index * pattern.blocks], pattern.blocks, 0);
+        depths[root_index] = 0;
+
+        auto nodes = search_trie<ParallelTrieImpl, early_break, collect_stats>(
+            trie, n, num_threads, [&](const NodePtrType& node) { calculate_children(node, pattern); });
+
+        std::vector<std::pair<float, std::string>> result(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            result[i] = std::make_pair(nodes[i].first, trie.get_word(nodes[i].second));
+        }
+        return result;
+    }
+
+  private:
+    alignas(CACHE_LINE_SIZE) const std::size_t num_threads;
+    alignas(CACHE_LINE_SIZE) ParallelTrieImpl trie;
+    alignas(CACHE_LINE_SIZE) std::vector<BitVector> vps;
+    std::vector<BitVector> vns;
+    std::vector<std::uint32_t> depths;
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "implementation/arena.hpp"
+#include "implementation/trie.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// SequentialTrie whose nodes store a 128 bit presence bitmap of the characters of their children and a dense array
+// of the children in the order of their characters. The child of character c is at the number of set bits below c
+// (popcnt). There is no table of 128 pointers per node, neither while building nor afterwards, and iterating the
+// children touches only existing ones.
+template <class PayloadType = DummyPayload> class BitmapSequentialTrie {
+
+  public:
+    struct BitmapSequentialTrieNode {
+        friend BitmapSequentialTrie;
+
+        static constexpr int CHAR_SIZE = 128;
+
+        BitmapSequentialTrieNode(BitmapSequentialTrieNode* parent, char character)
+            : leaf(false), character(character), num_children(0), parent(parent), bitmap{0, 0}, children(nullptr) {}
+
+      private:
+        bool leaf;
+        const char character;
+        std::uint8_t num_children;
+        // must be 0 for root
+        BitmapSequentialTrieNode* const parent;
+        PayloadType payload;
+
+        // bit c % 64 of bitmap[c / 64] is set if there is a child of character c
+        std::uint64_t bitmap[2];
+        // capacity: num_children rounded up to a power of two
+        BitmapSequentialTrieNode** children;
+        std::size_t index;
+    };
+
+  private:
+    using NodeType = BitmapSequentialTrieNode;
+    // free arrays of children per capacity 2^i, arrays move to the next class when a node outgrows them
+    static constexpr int NUM_CAPACITY_CLASSES = 8;
+
+  public:
+    using NodePtrType = NodeType*;
+    using ChildPtrIteratorType = BitmapSequentialTrieNode* const*;
+    NodePtrType null = nullptr;
+
+  public:
+    BitmapSequentialTrie() : root(arena.make<BitmapSequentialTrieNode>(nullptr, '\0')), num_nodes(1) {}
+
+    BitmapSequentialTrie([[maybe_unused]] std::size_t num_threads) : BitmapSequentialTrie() {}
+
+    void insert(std::vector<std::string>& words) {
+
+        // BUILD TRIE -----------------------------
+        for (std::string& word : words) {
+            NodeType* current = root;
+
+            for (std::size_t j = 0; j < word.size(); j++) {
+
+                // maybe a string containes special characters that do not
+                // fit in out datatype
+                assert(word[j] < NodeType::CHAR_SIZE && word[j] > 0);
+
+                NodePtrType child = get_child(current, word[j]);
+
+                if (child == nullptr) {
+                    child = arena.make<BitmapSequentialTrieNode>(current, word[j]);
+                    add_child(current, child);
+                    num_nodes++;
+                }
+
+                current = child;
+            }
+
+            current->leaf = true;
+        }
+
+        // SET INDICES -----------------------------
+
+        std::queue<NodePtrType> q;
+        q.push(root);
+
+        std::size_t index_ctr = 0;
+        while (!q.empty()) {
+            NodePtrType current = q.front();
+            q.pop();
+
+            current->index = index_ctr++;
+            for (std::size_t i = 0; i < current->num_children; i++)
+                q.push(current->children[i]);
+        }
+    }
+
+    // child of character c, nullptr if there is none
+    NodePtrType get_child(NodePtrType node_ptr, const char c) {
+        const int bit = static_cast<int>(c);
+        if (!((node_ptr->bitmap[bit / 64] >> (bit % 64)) & 1))
+            return nullptr;
+        return node_ptr->children[rank(node_ptr, bit)];
+    }
+
+    NodePtrType get_root() {
+        return root;
+    }
+
+    std::size_t get_num_nodes() {
+        return num_nodes;
+    }
+
+    // It must be guaranteed that children have subsequent indices!
+    std::size_t get_index(NodePtrType node_ptr) {
+        return node_ptr->index;
+    }
+
+    bool is_leaf(NodePtrType node_ptr) {
+        return node_ptr->leaf;
+    }
+
+    NodePtrType get_parent(NodePtrType node_ptr) {
+        return node_ptr->parent;
+    }
+
+    char get_character(NodePtrType node_ptr) {
+        return node_ptr->character;
+    }
+
+    PayloadType& get_payload(NodePtrType node_ptr) {
+        return node_ptr->payload;
+    }
+
+    std::pair<ChildPtrIteratorType, ChildPtrIteratorType> get_child_iterator(NodePtrType node_ptr) {
+        return {node_ptr->children, node_ptr->children + node_ptr->num_children};
+    }
+
+    NodePtrType dereference_child_iterator(ChildPtrIteratorType it) {
+        return *it;
+    }
+
+    std::string get_word(NodePtrType node_ptr) {
+        std::string result = "";
+
+        NodePtrType current = node_ptr;
+
+        while (current->parent) {
+            result = current->character + result;
+            current = current->parent;
+        }
+
+        return result;
+    }
+
+  private:
+    // number of children with a character below bit
+    static std::size_t rank(NodePtrType node_ptr, const int bit) {
+        const std::uint64_t below = (std::uint64_t(1) << (bit % 64)) - 1;
+        if (bit < 64)
+            return std::popcount(node_ptr->bitmap[0] & below);
+        return std::popcount(node_ptr->bitmap[0]) + std::popcount(node_ptr->bitmap[1] & below);
+    }
+
+    void add_child(NodePtrType node_ptr, NodePtrType child) {
+        const int bit = static_cast<int>(child->character);
+        const std::size_t position = rank(node_ptr, bit);
+        const std::size_t size = node_ptr->num_children;
+
+        // full if the size is a power of two
+        if (std::has_single_bit(size) || size == 0) {
+            NodePtrType* grown = allocate_children(size ? 2 * size : 1);
+            std::memcpy(grown, node_ptr->children, size * sizeof(NodePtrType));
+            if (size)
+                free_children[std::countr_zero(size)].push_back(node_ptr->children);
+            node_ptr->children = grown;
+        }
+
+        std::memmove(node_ptr->children + position + 1, node_ptr->children + position,
+                     (size - position) * sizeof(NodePtrType));
+        node_ptr->children[position] = child;
+        node_ptr->num_children++;
+        node_ptr->bitmap[bit / 64] |= std::uint64_t(1) << (bit % 64);
+    }
+
+    NodePtrType* allocate_children(const std::size_t capacity) {
+        std::vector<NodePtrType*>& free = free_children[std::countr_zero(capacity)];
+        if (free.empty())
+            return arena.make_array<NodePtrType>(capacity);
+
+        NodePtrType* children = free.back();
+        free.pop_back();
+        return children;
+    }
+
+  private:
+    Arena arena;
+    NodePtrType root;
+    std::size_t num_nodes;
+    std::vector<NodePtrType*> free_children[NUM_CAPACITY_CLASSES];
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "implementation/trie.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// VectorizedParallelTrie in a compact struct-of-arrays layout with 32 bit indices. The nodes are numbered breadth
+// first, so the children of node i are [first_child[i], first_child[i + 1]) (CSR) and no end index is stored. The
+// leaf flags are packed into bits and the payload is kept in its own array, which leaves about 9 bytes per node
+// instead of 40 and keeps the arrays a traversal reads dense. insert throws std::length_error if the nodes do not fit
+// into the indices.
+template <class PayloadType = DummyPayload, bool collect_stats = false> class CompactTrie {
+
+  private:
+    using HelperType = ParallelTrie<DummyPayload>;
+    using HelperNodePtrType = typename HelperType::NodePtrType;
+
+  public:
+    using NodePtrType = std::uint32_t;
+    using ChildPtrIteratorType = std::uint32_t;
+    static const NodePtrType null = 0;
+
+  public:
+    CompactTrie(std::size_t num_threads = std::thread::hardware_concurrency()) : num_threads(num_threads) {}
+
+    void insert(std::vector<std::string>& words) {
+        HelperType helper(num_threads);
+        helper.insert(words);
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("compact");
+        }
+
+        const std::size_t num_nodes = helper.get_num_nodes();
+        if (num_nodes >= std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("the trie has more nodes than a CompactTrie can index");
+
+        characters.assign(num_nodes, '\0');
+        parents.assign(num_nodes, 0);
+        first_child.assign(num_nodes + 1, 0);
+        leaves.assign((num_nodes + 63) / 64, 0);
+        payloads.assign(num_nodes, PayloadType());
+
+        // breadth first numbering, the children of a node follow the children of the previous node
+        std::queue<HelperNodePtrType> queue;
+        queue.push(helper.get_root());
+        NodePtrType next_index = 1;
+
+        for (NodePtrType index = 0; !queue.empty(); index++) {
+            HelperNodePtrType helper_node = queue.front();
+            queue.pop();
+
+            first_child[index] = next_index;
+
+            auto iters = helper.get_child_iterator(helper_node);
+            for (auto it = iters.first; it != iters.second; it++) {
+                HelperNodePtrType child = helper.dereference_child_iterator(it);
+
+                characters[next_index] = helper.get_character(child);
+                parents[next_index] = index;
+                if (helper.is_leaf(child))
+                    leaves[next_index / 64] |= std::uint64_t(1) << (next_index % 64);
+
+                queue.push(child);
+                next_index++;
+            }
+        }
+        first_child[num_nodes] = num_nodes;
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+            statistics_collector::get().add_stat("bytes", std::to_string(get_memory_usage()));
+        }
+    }
+
+    NodePtrType get_root() {
+        return 0;
+    }
+
+    std::size_t get_num_nodes() {
+        return characters.size();
+    }
+
+    std::size_t get_index(NodePtrType node_ptr) {
+        return node_ptr;
+    }
+
+    bool is_leaf(NodePtrType node_ptr) {
+        return (leaves[node_ptr / 64] >> (node_ptr % 64)) & 1;
+    }
+
+    NodePtrType get_parent(NodePtrType node_ptr) {
+        return parents[node_ptr];
+    }
+
+    char get_character(NodePtrType node_ptr) {
+        return characters[node_ptr];
+    }
+
+    PayloadType& get_payload(NodePtrType node_ptr) {
+        return payloads[node_ptr];
+    }
+
+    std::pair<ChildPtrIteratorType, ChildPtrIteratorType> get_child_iterator(NodePtrType node_ptr) {
+        return {first_child[node_ptr], first_child[node_ptr + 1]};
+    }
+
+    NodePtrType dereference_child_iterator(ChildPtrIteratorType it) {
+        return it;
+    }
+
+    std::string get_word(NodePtrType node_ptr) {
+        std::string result = "";
+
+        NodePtrType current = node_ptr;
+
+        while (current) {
+            result = characters[current] + result;
+            current = parents[current];
+        }
+
+        return result;
+    }
+
+    // bytes of the trie structure and the payloads
+    std::size_t get_memory_usage() const {
+        return characters.size() * sizeof(char) + parents.size() * sizeof(NodePtrType) +
+               first_child.size() * sizeof(NodePtrType) + leaves.size() * sizeof(std::uint64_t) +
+               payloads.size() * sizeof(PayloadType);
+    }
+
+  private:
+    std::vector<char> characters;
+    std::vector<NodePtrType> parents;
+    // children of node i: [first_child[i], first_child[i + 1])
+    std::vector<NodePtrType> first_child;
+    // bit i % 64 of leaves[i / 64]
+    std::vector<std::uint64_t> leaves;
+    std::vector<PayloadType> payloads;
+
+    std::size_t num_threads;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Runtime selection of the instruction set for the dp kernels. The build targets the baseline (-msse4.2), the
+// kernels are additionally compiled for AVX2 and AVX-512 and the best variant the cpu supports is used.
+//
+// The variant can be forced for benchmarks with the environment variable LEV_FORCE_ISA (sse4.2, avx2, avx512) or
+// with cpu_dispatch::force (the time_* drivers take -isa). Variants the cpu does not support fall back to the best
+// supported one.
+namespace cpu_dispatch {
+
+enum class Isa { SSE42 = 0, AVX2 = 1, AVX512 = 2 };
+
+inline const char* to_string(const Isa isa) {
+    switch (isa) {
+    case Isa::AVX512:
+        return "avx512";
+    case Isa::AVX2:
+        return "avx2";
+    default:
+        return "sse4.2";
+    }
+}
+
+// returns false for unknown names
+inline bool parse(const std::string& name, Isa& isa) {
+    for (Isa candidate : {Isa::SSE42, Isa::AVX2, Isa::AVX512}) {
+        if (name == to_string(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// best variant of the cpu
+inline Isa detect() {
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl"))
+        return Isa::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return Isa::AVX2;
+    return Isa::SSE42;
+}
+
+namespace detail {
+inline Isa& current() {
+    static Isa isa = []() {
+        Isa best = detect();
+
+        const char* forced = std::getenv("LEV_FORCE_ISA");
+        Isa isa;
+        if (forced && parse(forced, isa))
+            return std::min(isa, best);
+        if (forced)
+            std::cerr << "LEV_FORCE_ISA: unknown instruction set " << forced << std::endl;
+
+        return best;
+    }();
+    return isa;
+}
+} // namespace detail
+
+inline Isa selected() {
+    return detail::current();
+}
+
+// returns the variant that is used from now on
+inline Isa force(const Isa isa) {
+    return detail::current() = std::min(isa, detect());
+}
+
+// flatten inlines the whole call tree of kernel, so everything it calls is compiled for the instruction set
+template <class Kernel> __attribute__((flatten)) inline auto run_sse42(const Kernel& kernel) {
+    return kernel();
+}
+
+template <class Kernel> __attribute__((target("avx2,fma"), flatten)) inline auto run_avx2(const Kernel& kernel) {
+    return kernel();
+}
+
+template <class Kernel>
+__attribute__((target("avx512f,avx512bw,avx512vl,avx2,fma"), flatten)) inline auto run_avx512(const Kernel& kernel) {
+    return kernel();
+}
+
+// Calls kernel() in the selected variant. The switch is well predicted, it costs next to nothing per call.
+template <class Kernel> inline auto dispatch(const Kernel& kernel) {
+    switch (selected()) {
+    case Isa::AVX512:
+        return run_avx512(kernel);
+    case Isa::AVX2:
+        return run_avx2(kernel);
+    default:
+        return run_sse42(kernel);
+    }
+}
+
+} // namespace cpu_dispatch
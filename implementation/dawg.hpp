@@ -0,0 +1,204 @@
+#pragma once
+
+#include "utils/statistics_collector.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <boost/sort/sort.hpp>
+
+// Minimal deterministic acyclic automaton of the words (DAWG): the trie with equal sub-tries merged, so common
+// suffixes (inflections) are stored once. A state has no parent and no single word, the word of a search is the
+// path to it. Built from the sorted words with the incremental algorithm of Daciuk et al.: the states of the
+// previous word below the common prefix are complete and are either replaced by an equal registered state or
+// registered themselves. The states are numbered in the order they are registered, the children before their
+// parent, so the root is the last one. The transitions of state s are [first_edge[s], first_edge[s + 1]), sorted
+// by character.
+template <bool collect_stats = false> class Dawg {
+
+  public:
+    using StateType = std::uint32_t;
+
+  public:
+    Dawg(std::size_t num_threads = std::thread::hardware_concurrency()) : num_threads(num_threads) {}
+
+    void insert(std::vector<std::string>& words) {
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("sort");
+        }
+        std::vector<std::string> sorted_words = words;
+        boost::sort::sample_sort(sorted_words.begin(), sorted_words.end(), num_threads);
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+        }
+
+        insert_sorted(sorted_words);
+    }
+
+    // words must be sorted, duplicates are skipped
+    void insert_sorted(std::vector<std::string>& words) {
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("minimize");
+        }
+
+        first_edge.assign(1, 0);
+        characters.clear();
+        targets.clear();
+        finals.clear();
+        Registry registry(0, StateHash{this}, StateEqual{this});
+
+        // the states of the previous word, each but the last with a pending transition to the next one
+        std::vector<PathState> path(1);
+        std::size_t num_trie_nodes = 1;
+        const std::string* previous = nullptr;
+
+        for (const std::string& word : words) {
+            std::size_t prefix = 0;
+            if (previous) {
+                const std::size_t max_prefix = std::min(previous->size(), word.size());
+                while (prefix < max_prefix && (*previous)[prefix] == word[prefix])
+                    prefix++;
+            }
+
+            freeze_path(path, prefix, registry);
+
+            for (std::size_t i = prefix; i < word.size(); i++) {
+                assert(word[i] < 128 && word[i] > 0);
+                path.back().edges.emplace_back(word[i], PENDING);
+                path.emplace_back();
+            }
+            path.back().final = true;
+
+            num_trie_nodes += word.size() - prefix;
+            previous = &word;
+        }
+
+        freeze_path(path, 0, registry);
+        root = register_state(path[0], registry);
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+            statistics_collector::get().add_stat("trie_nodes", std::to_string(num_trie_nodes));
+            statistics_collector::get().add_stat("dawg_states", std::to_string(get_num_states()));
+            statistics_collector::get().add_stat("dawg_edges", std::to_string(get_num_edges()));
+            statistics_collector::get().add_stat("bytes", std::to_string(get_memory_usage()));
+        }
+    }
+
+    StateType get_root() const {
+        return root;
+    }
+
+    std::size_t get_num_states() const {
+        return first_edge.size() - 1;
+    }
+
+    std::size_t get_num_edges() const {
+        return characters.size();
+    }
+
+    bool is_final(StateType state) const {
+        return finals[state];
+    }
+
+    // indices of the transitions of state
+    std::pair<std::size_t, std::size_t> get_edges(StateType state) const {
+        return {first_edge[state], first_edge[state + 1]};
+    }
+
+    char get_character(std::size_t edge) const {
+        return characters[edge];
+    }
+
+    StateType get_target(std::size_t edge) const {
+        return targets[edge];
+    }
+
+    std::size_t get_memory_usage() const {
+        return first_edge.size() * sizeof(std::uint32_t) + characters.size() * sizeof(char) +
+               targets.size() * sizeof(StateType) + finals.size() / 8;
+    }
+
+  private:
+    static constexpr StateType PENDING = std::numeric_limits<StateType>::max();
+
+    struct PathState {
+        bool final = false;
+        std::vector<std::pair<char, StateType>> edges;
+    };
+
+    // hash and equality of registered states by their transitions and final flag
+    struct StateHash {
+        const Dawg* dawg;
+        std::size_t operator()(StateType state) const {
+            std::size_t hash = dawg->finals[state];
+            for (std::uint32_t edge = dawg->first_edge[state]; edge < dawg->first_edge[state + 1]; edge++)
+                hash = (hash * 31 + static_cast<std::size_t>(dawg->characters[edge])) * 1000003 + dawg->targets[edge];
+            return hash;
+        }
+    };
+
+    struct StateEqual {
+        const Dawg* dawg;
+        bool operator()(StateType a, StateType b) const {
+            const std::uint32_t a_begin = dawg->first_edge[a];
+            const std::uint32_t b_begin = dawg->first_edge[b];
+            const std::uint32_t size = dawg->first_edge[a + 1] - a_begin;
+            return dawg->finals[a] == dawg->finals[b] && size == dawg->first_edge[b + 1] - b_begin &&
+                   std::equal(&dawg->characters[a_begin], &dawg->characters[a_begin] + size,
+                              &dawg->characters[b_begin]) &&
+                   std::equal(&dawg->targets[a_begin], &dawg->targets[a_begin] + size, &dawg->targets[b_begin]);
+        }
+    };
+
+    using Registry = std::unordered_set<StateType, StateHash, StateEqual>;
+
+    // replaces or registers the states of the path below depth, bottom up
+    void freeze_path(std::vector<PathState>& path, std::size_t depth, Registry& registry) {
+        while (path.size() > depth + 1) {
+            const StateType state = register_state(path.back(), registry);
+            path.pop_back();
+            path.back().edges.back().second = state;
+        }
+    }
+
+    // The state is appended as the next one and looked up, an equal state found is returned and the new one
+    // removed again.
+    StateType register_state(const PathState& path_state, Registry& registry) {
+        assert(characters.size() + path_state.edges.size() < std::numeric_limits<std::uint32_t>::max());
+
+        const auto state = static_cast<StateType>(get_num_states());
+        for (const auto& [character, target] : path_state.edges) {
+            characters.push_back(character);
+            targets.push_back(target);
+        }
+        first_edge.push_back(static_cast<std::uint32_t>(characters.size()));
+        finals.push_back(path_state.final);
+
+        const auto [it, inserted] = registry.insert(state);
+        if (inserted)
+            return state;
+
+        characters.resize(first_edge[state]);
+        targets.resize(first_edge[state]);
+        first_edge.pop_back();
+        finals.pop_back();
+        return *it;
+    }
+
+  private:
+    std::size_t num_threads;
+    StateType root = 0;
+
+    std::vector<std::uint32_t> first_edge;
+    std::vector<char> characters;
+    std::vector<StateType> targets;
+    std::vector<bool> finals;
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "implementation/levenshtein_penalty_functions.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace levenshtein {
+
+// INSERT: a character of the word that is missing in the query, REMOVE: a character of the query that is not in the
+// word, MODIFY: a character of the word typed as a different character of the query
+enum class EditType { MATCH, MODIFY, INSERT, REMOVE };
+
+struct Edit {
+    EditType type;
+    // character of the word, '\0' for REMOVE
+    char word_character;
+    // character of the query, '\0' for INSERT
+    char query_character;
+    float cost;
+};
+
+struct EditScript {
+    float cost = 0;
+    // in the order of the characters
+    std::vector<Edit> edits;
+};
+
+// Optimal alignment of a query and a word under the costs of a penalty class, with Hirschberg's divide and conquer:
+// the middle character of the word is aligned by a forward and a backward pass over the dp (one row each), then
+// both halves are solved independently. Takes O(|word| * |query|) time and O(|query|) memory.
+template <class PenaltyClass> class Hirschberg {
+  public:
+    Hirschberg(const PenaltyClass& penalty, const std::string& query, const std::string& word)
+        : penalty(penalty), query(query), word(word), forward(query.size() + 1), backward(query.size() + 1) {}
+
+    EditScript run() {
+        EditScript script;
+        align(0, word.size(), 0, query.size(), script);
+
+        for (const Edit& edit : script.edits)
+            script.cost += edit.cost;
+
+        return script;
+    }
+
+  private:
+    // aligns word[word_begin, word_end) with query[query_begin, query_end)
+    void align(std::size_t word_begin, std::size_t word_end, std::size_t query_begin, std::size_t query_end,
+               EditScript& script) {
+        if (word_end - word_begin <= 1) {
+            align_character(word_begin, word_end, query_begin, query_end, script);
+            return;
+        }
+
+        const std::size_t word_mid = (word_begin + word_end) / 2;
+
+        // forward: word[word_begin, word_mid) against query[query_begin, j)
+        forward[query_begin] = 0;
+        for (std::size_t j = query_begin + 1; j <= query_end; j++)
+            forward[j] = forward[j - 1] + penalty.remove(query[j - 1]);
+
+        for (std::size_t i = word_begin; i < word_mid; i++) {
+            const float insert_penalty = penalty.insert(word[i]);
+            float diagonal = forward[query_begin];
+            forward[query_begin] += insert_penalty;
+
+            for (std::size_t j = query_begin + 1; j <= query_end; j++) {
+                const float above = forward[j];
+                forward[j] = std::min(std::min(above + insert_penalty, forward[j - 1] + penalty.remove(query[j - 1])),
+                                      diagonal + penalty.modify(word[i], query[j - 1]));
+                diagonal = above;
+            }
+        }
+
+        // backward: word[word_mid, word_end) against query[j, query_end)
+        backward[query_end] = 0;
+        for (std::size_t j = query_end; j-- > query_begin;)
+            backward[j] = backward[j + 1] + penalty.remove(query[j]);
+
+        for (std::size_t i = word_end; i-- > word_mid;) {
+            const float insert_penalty = penalty.insert(word[i]);
+            float diagonal = backward[query_end];
+            backward[query_end] += insert_penalty;
+
+            for (std::size_t j = query_end; j-- > query_begin;) {
+                const float below = backward[j];
+                backward[j] = std::min(std::min(below + insert_penalty, backward[j + 1] + penalty.remove(query[j])),
+                                       diagonal + penalty.modify(word[i], query[j]));
+                diagonal = below;
+            }
+        }
+
+        std::size_t query_mid = query_begin;
+        for (std::size_t j = query_begin + 1; j <= query_end; j++) {
+            if (forward[j] + backward[j] < forward[query_mid] + backward[query_mid])
+                query_mid = j;
+        }
+
+        align(word_begin, word_mid, query_begin, query_mid, script);
+        align(word_mid, word_end, query_mid, query_end, script);
+    }
+
+    // at most one character of the word: it is either inserted or aligned with one character of the query, all other
+    // characters of the query are removed
+    void align_character(std::size_t word_begin, std::size_t word_end, std::size_t query_begin, std::size_t query_end,
+                         EditScript& script) {
+        float removed = 0;
+        for (std::size_t j = query_begin; j < query_end; j++)
+            removed += penalty.remove(query[j]);
+
+        // query_end: the character is inserted
+        std::size_t aligned = query_end;
+        float best = word_begin < word_end ? removed + penalty.insert(word[word_begin]) : removed;
+
+        for (std::size_t j = query_begin; j < query_end && word_begin < word_end; j++) {
+            const float cost = removed - penalty.remove(query[j]) + penalty.modify(word[word_begin], query[j]);
+            if (cost < best) {
+                best = cost;
+                aligned = j;
+            }
+        }
+
+        for (std::size_t j = query_begin; j < query_end; j++) {
+            if (j == aligned) {
+                const float cost = penalty.modify(word[word_begin], query[j]);
+                const EditType type = word[word_begin] == query[j] ? EditType::MATCH : EditType::MODIFY;
+                script.edits.push_back(Edit{type, word[word_begin], query[j], cost});
+            } else {
+                script.edits.push_back(Edit{EditType::REMOVE, '\0', query[j], penalty.remove(query[j])});
+            }
+        }
+
+        if (word_begin < word_end && aligned == query_end) {
+            script.edits.push_back(Edit{EditType::INSERT, word[word_begin], '\0', penalty.insert(word[word_begin])});
+        }
+    }
+
+  private:
+    const PenaltyClass& penalty;
+    const std::string& query;
+    const std::string& word;
+    std::vector<float> forward;
+    std::vector<float> backward;
+};
+
+template <class PenaltyClass>
+EditScript explain(const PenaltyClass& penalty, const std::string& query, const std::string& word) {
+    return Hirschberg<PenaltyClass>(penalty, query, word).run();
+}
+
+} // namespace levenshtein
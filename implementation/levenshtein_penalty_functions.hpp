@@ -1,7 +1,12 @@
 #pragma once
 
+#include "implementation/alphabet.hpp"
+
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 namespace levenshtein {
 class SimplePenalty {
@@ -20,6 +25,30 @@ class SimplePenalty {
     float remove(char) {
         return 1.f;
     }
+
+    float transpose(char, char) {
+        return 0.5f;
+    }
+};
+
+// Plain Levenshtein distance: every edit costs 1. BitParallelLevenshtein is restricted to these costs.
+class UnitPenalty {
+  public:
+    float modify(char from, char to) const {
+        return from == to ? 0.f : 1.f;
+    }
+
+    float insert(char) const {
+        return 1.f;
+    }
+
+    float remove(char) const {
+        return 1.f;
+    }
+
+    float transpose(char, char) const {
+        return 1.f;
+    }
 };
 
 class KBDistance {
@@ -90,8 +119,109 @@ class KBDistance {
         return 2.f;
     }
 
+    // Swapping two adjacent characters ("teh" for "the") is a single slip of the fingers, it never costs more than
+    // the two modifications it replaces
+    float transpose(char first, char second) const {
+        return std::min(.3f, modify(first, second) + modify(second, first));
+    }
+
+    // The count keys closest to c (in the case of c), with the cost of modifying them into c
+    std::vector<std::pair<char, float>> neighbours(char c, std::size_t count) const {
+        std::vector<std::pair<char, float>> result;
+        const char lower = c | (1 << 5);
+
+        if (lower > 'z' || lower < 'a')
+            return result;
+
+        for (char key = 'a'; key <= 'z'; key++) {
+            if (key != lower)
+                result.emplace_back(c == lower ? key : key & ~(1 << 5), modify(key, lower));
+        }
+
+        std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+        result.resize(std::min(count, result.size()));
+
+        return result;
+    }
+
   private:
     float probabilities[26];
     float table[26][26];
 };
+
+// PenaltyClass over the dense symbols of an Alphabet, as tables of size() + 2 entries per dimension (the symbols, the
+// unused 0 and the unknown symbol). A symbol is charged like its ASCII letter without diacritics (utf8::fold), a
+// change of the diacritic only ('a' -> 'ä') like a change of case, and code points without such a letter like
+// characters that are no letters.
+template <class PenaltyClass> class DensePenalty {
+
+  public:
+    DensePenalty(const PenaltyClass& penalty, const Alphabet& alphabet) : size(alphabet.size() + 2) {
+        modify_table.resize(size * size);
+        transpose_table.resize(size * size);
+        insert_table.resize(size);
+        remove_table.resize(size);
+
+        std::vector<char> letters(size);
+        for (std::size_t symbol = 0; symbol < size; symbol++) {
+            const char letter = utf8::fold(alphabet.get_code_point(static_cast<char>(symbol)));
+            letters[symbol] = letter ? letter : NO_LETTER;
+        }
+
+        for (std::size_t from = 0; from < size; from++) {
+            insert_table[from] = penalty.insert(letters[from]);
+            remove_table[from] = penalty.remove(letters[from]);
+
+            for (std::size_t to = 0; to < size; to++) {
+                char from_letter = letters[from];
+                char to_letter = letters[to];
+
+                // different symbols that share the letter
+                if (from != to && from_letter == to_letter) {
+                    const bool is_letter = (from_letter | (1 << 5)) >= 'a' && (from_letter | (1 << 5)) <= 'z';
+                    to_letter = is_letter ? from_letter ^ (1 << 5) : OTHER_NO_LETTER;
+                    from_letter = is_letter ? from_letter : NO_LETTER;
+                }
+
+                modify_table[from * size + to] = from == to ? 0.f : penalty.modify(from_letter, to_letter);
+                transpose_table[from * size + to] = penalty.transpose(from_letter, to_letter);
+            }
+        }
+    }
+
+    float modify(char from, char to) const {
+        return modify_table[index(from) * size + index(to)];
+    }
+
+    float insert(char c) const {
+        return insert_table[index(c)];
+    }
+
+    float remove(char c) const {
+        return remove_table[index(c)];
+    }
+
+    float transpose(char first, char second) const {
+        return transpose_table[index(first) * size + index(second)];
+    }
+
+  private:
+    // stand-ins for code points without a letter
+    static constexpr char NO_LETTER = '\x01';
+    static constexpr char OTHER_NO_LETTER = '\x02';
+
+    // bytes outside the alphabet are charged like the unknown symbol
+    std::size_t index(char symbol) const {
+        const auto index = static_cast<std::size_t>(static_cast<unsigned char>(symbol));
+        return index < size ? index : size - 1;
+    }
+
+  private:
+    std::size_t size;
+    // [from * size + to]
+    std::vector<float> modify_table;
+    std::vector<float> transpose_table;
+    std::vector<float> insert_table;
+    std::vector<float> remove_table;
+};
 } // namespace levenshtein
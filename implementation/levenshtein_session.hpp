@@ -0,0 +1,136 @@
+#pragma once
+
+#include "implementation/levenshtein_penalty_functions.hpp"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+// Incremental query for input that grows one character at a time (e.g. a keyboard). The session keeps one sparse dp
+// column per typed character: the nodes whose distance to the typed prefix is at most max_cost (the active set).
+// push_char() derives the next column from the active set only, pop_char() drops the last column, so the cost per
+// keystroke is proportional to the active set and not to the length of the query.
+//
+// The session references the trie and penalty of the engine that created it: the engine must outlive the session and
+// must not be re-precomputed in the meantime.
+template <class PenaltyClass, class TrieImpl> class LevenshteinSession {
+
+  private:
+    using NodePtrType = typename TrieImpl::NodePtrType;
+    using ChildPtrIteratorType = typename TrieImpl::ChildPtrIteratorType;
+
+    // node, distance of the path to the node to the typed prefix
+    using Column = std::vector<std::pair<NodePtrType, float>>;
+
+  public:
+    LevenshteinSession(TrieImpl& trie, const PenaltyClass& penalty, const float max_cost)
+        : trie(trie), penalty(penalty), max_cost(max_cost) {
+
+        // empty prefix: only insertions starting from the root
+        std::map<std::size_t, std::pair<NodePtrType, float>> column;
+        relax(column, trie.get_root(), 0.f);
+        propagate_inserts(column);
+        push_column(column);
+    }
+
+    void push_char(const char c) {
+        std::map<std::size_t, std::pair<NodePtrType, float>> column;
+
+        for (const auto& [node, distance] : columns.back()) {
+            // c is not part of the word
+            relax(column, node, distance + penalty.remove(c));
+
+            // c is (a modified version of) the next character of the word
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType end;
+            for (std::tie(it, end) = trie.get_child_iterator(node); it != end; it++) {
+                NodePtrType child = trie.dereference_child_iterator(it);
+                relax(column, child, distance + penalty.modify(trie.get_character(child), c));
+            }
+        }
+
+        propagate_inserts(column);
+        push_column(column);
+        typed.push_back(c);
+    }
+
+    void pop_char() {
+        if (typed.empty())
+            return;
+
+        columns.pop_back();
+        typed.pop_back();
+    }
+
+    const std::string& get_query() const noexcept {
+        return typed;
+    }
+
+    std::size_t active_nodes() const noexcept {
+        return columns.back().size();
+    }
+
+    // best n words within max_cost of the typed query, ordered by distance
+    std::vector<std::pair<float, std::string>> results(const std::size_t n) {
+        std::vector<std::pair<float, NodePtrType>> leaves;
+        for (const auto& [node, distance] : columns.back()) {
+            if (trie.is_leaf(node))
+                leaves.emplace_back(distance, node);
+        }
+
+        const std::size_t count = std::min(n, leaves.size());
+        std::partial_sort(leaves.begin(), leaves.begin() + count, leaves.end());
+
+        std::vector<std::pair<float, std::string>> result(count);
+        for (std::size_t i = 0; i < count; i++) {
+            result[i] = std::make_pair(leaves[i].first, trie.get_word(leaves[i].second));
+        }
+
+        return result;
+    }
+
+  private:
+    inline void relax(std::map<std::size_t, std::pair<NodePtrType, float>>& column, NodePtrType node,
+                      const float distance) {
+        if (distance > max_cost)
+            return;
+
+        auto [entry, inserted] = column.try_emplace(trie.get_index(node), node, distance);
+        if (!inserted)
+            entry->second.second = std::min(entry->second.second, distance);
+    }
+
+    // Children have larger indices than their parent, so every node is final once the ordered iteration reaches it
+    // and the inserted children are visited later on.
+    void propagate_inserts(std::map<std::size_t, std::pair<NodePtrType, float>>& column) {
+        for (auto entry = column.begin(); entry != column.end(); entry++) {
+            const auto [node, distance] = entry->second;
+
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType end;
+            for (std::tie(it, end) = trie.get_child_iterator(node); it != end; it++) {
+                NodePtrType child = trie.dereference_child_iterator(it);
+                relax(column, child, distance + penalty.insert(trie.get_character(child)));
+            }
+        }
+    }
+
+    void push_column(const std::map<std::size_t, std::pair<NodePtrType, float>>& column) {
+        Column& result = columns.emplace_back();
+        result.reserve(column.size());
+
+        for (const auto& entry : column) {
+            result.push_back(entry.second);
+        }
+    }
+
+  private:
+    TrieImpl& trie;
+    const PenaltyClass& penalty;
+    const float max_cost;
+
+    std::string typed;
+    // columns[i] is the active set after typing i characters
+    std::vector<Column> columns;
+};
@@ -0,0 +1,403 @@
+#pragma once
+
+#include "implementation/trie.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/sort/sort.hpp>
+
+// Bit vector with constant time rank and select. The number of ones before every block of BLOCK_BITS bits is stored
+// (rank directory), and the block of every SAMPLE_RATE-th one (select samples). select1 finds the block by a binary
+// search between two samples and the bit by popcounts. select0 is on the path of every child lookup of a LoudsTrie,
+// so the position of every ZERO_SAMPLE_RATE-th zero is stored and select0 scans at most a few words from there, for
+// half a bit per zero. The samples are 32 bit, build() throws std::length_error for more than 2^32 - 1 bits.
+class RankSelectBitVector {
+
+  private:
+    static constexpr std::size_t WORDS_PER_BLOCK = 8;
+    static constexpr std::size_t BLOCK_BITS = 64 * WORDS_PER_BLOCK;
+    static constexpr std::size_t SAMPLE_RATE = 1024;
+    static constexpr std::size_t ZERO_SAMPLE_RATE = 64;
+
+  public:
+    void push_back(bool bit) {
+        if (num_bits % 64 == 0)
+            words.push_back(0);
+        words.back() |= std::uint64_t(bit) << (num_bits % 64);
+        num_bits++;
+    }
+
+    // builds the directories, must be called after the last push_back
+    void build() {
+        const std::size_t num_blocks = (words.size() + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK;
+        block_ranks.assign(num_blocks + 1, 0);
+        select_samples.clear();
+        zero_positions.clear();
+
+        std::size_t ones = 0;
+        for (std::size_t block = 0; block < num_blocks; block++) {
+            block_ranks[block] = ones;
+
+            const std::size_t block_ones = count_ones(block);
+
+            // the samples that fall into this block
+            while (select_samples.size() * SAMPLE_RATE < ones + block_ones)
+                select_samples.push_back(static_cast<std::uint32_t>(block));
+
+            ones += block_ones;
+        }
+        block_ranks[num_blocks] = ones;
+        num_ones = ones;
+
+        if (num_bits > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("a RankSelectBitVector holds at most 2^32 - 1 bits");
+        for (std::size_t position = 0, zeros = 0; position < num_bits; position++) {
+            if (!(*this)[position] && zeros++ % ZERO_SAMPLE_RATE == 0)
+                zero_positions.push_back(static_cast<std::uint32_t>(position));
+        }
+    }
+
+    bool operator[](std::size_t position) const {
+        return (words[position / 64] >> (position % 64)) & 1;
+    }
+
+    std::size_t size() const {
+        return num_bits;
+    }
+
+    // number of ones in [0, position)
+    std::size_t rank1(std::size_t position) const {
+        const std::size_t word = position / 64;
+        std::size_t rank = block_ranks[word / WORDS_PER_BLOCK];
+        for (std::size_t i = word - word % WORDS_PER_BLOCK; i < word; i++)
+            rank += std::popcount(words[i]);
+        if (position % 64)
+            rank += std::popcount(words[word] & ((std::uint64_t(1) << (position % 64)) - 1));
+        return rank;
+    }
+
+    std::size_t rank0(std::size_t position) const {
+        return position - rank1(position);
+    }
+
+    // position of the k-th one, counting from 0
+    std::size_t select1(std::size_t k) const {
+        assert(k < num_ones);
+        const std::size_t sample = k / SAMPLE_RATE;
+
+        // last block in [low, high] with fewer than k + 1 ones before it
+        std::size_t low = select_samples[sample];
+        std::size_t high = sample + 1 < select_samples.size() ? select_samples[sample + 1] : block_ranks.size() - 2;
+        while (low < high) {
+            const std::size_t middle = (low + high + 1) / 2;
+            if (block_ranks[middle] <= k)
+                low = middle;
+            else
+                high = middle - 1;
+        }
+
+        std::size_t remaining = k - block_ranks[low];
+        for (std::size_t i = low * WORDS_PER_BLOCK;; i++) {
+            const std::size_t count = std::popcount(words[i]);
+            if (remaining < count)
+                return i * 64 + select_in_word(words[i], remaining);
+            remaining -= count;
+        }
+    }
+
+    // position of the k-th zero, counting from 0
+    std::size_t select0(std::size_t k) const {
+        assert(k < num_bits - num_ones);
+        const std::size_t position = zero_positions[k / ZERO_SAMPLE_RATE];
+        std::size_t remaining = k % ZERO_SAMPLE_RATE;
+
+        // the zeros of the first word from the sample on
+        std::size_t i = position / 64;
+        std::uint64_t word = ~words[i] & (~std::uint64_t(0) << (position % 64));
+        while (true) {
+            const std::size_t count = std::popcount(word);
+            if (remaining < count)
+                return i * 64 + select_in_word(word, remaining);
+            remaining -= count;
+            word = ~words[++i];
+        }
+    }
+
+    // number of consecutive ones from position on, the bits after the last one are zero
+    std::size_t count_run_of_ones(std::size_t position) const {
+        std::size_t run = 0;
+        while (position < num_bits) {
+            const std::size_t remaining = 64 - position % 64;
+            const std::size_t ones = std::countr_one(words[position / 64] >> (position % 64));
+            if (ones < remaining)
+                return run + ones;
+            run += remaining;
+            position += remaining;
+        }
+        return run;
+    }
+
+    // bytes of the bits and the directories
+    std::size_t get_memory_usage() const {
+        return words.size() * sizeof(std::uint64_t) + block_ranks.size() * sizeof(std::uint64_t) +
+               (select_samples.size() + zero_positions.size()) * sizeof(std::uint32_t);
+    }
+
+  private:
+    std::size_t count_ones(std::size_t block) const {
+        std::size_t ones = 0;
+        for (std::size_t i = block * WORDS_PER_BLOCK; i < std::min(words.size(), (block + 1) * WORDS_PER_BLOCK); i++)
+            ones += std::popcount(words[i]);
+        return ones;
+    }
+
+    // position of the k-th set bit of word, which has more than k set bits. Without branches: the prefix sums of the
+    // popcounts of the bytes are compared with k all at once, which gives the byte, and a table the bit in the byte.
+    static std::size_t select_in_word(std::uint64_t word, std::size_t k) {
+        constexpr std::uint64_t ONES = 0x0101010101010101;
+        constexpr std::uint64_t HIGHS = 0x8080808080808080;
+
+        std::uint64_t counts = word - ((word >> 1) & 0x5555555555555555);
+        counts = (counts & 0x3333333333333333) + ((counts >> 2) & 0x3333333333333333);
+        counts = (counts + (counts >> 4)) & 0x0f0f0f0f0f0f0f0f;
+        const std::uint64_t prefix_sums = counts * ONES;
+
+        // number of bytes whose prefix sum is at most k
+        const std::size_t byte = std::popcount((((k * ONES) | HIGHS) - prefix_sums) & HIGHS);
+        const std::size_t before = ((prefix_sums << 8) >> (8 * byte)) & 0xff;
+        return 8 * byte + SELECT_IN_BYTE[(word >> (8 * byte)) & 0xff][k - before];
+    }
+
+    // SELECT_IN_BYTE[b][k]: position of the k-th set bit of b
+    static constexpr auto SELECT_IN_BYTE = [] {
+        std::array<std::array<std::uint8_t, 8>, 256> table{};
+        for (std::size_t b = 0; b < 256; b++) {
+            for (std::size_t bit = 0, k = 0; bit < 8; bit++) {
+                if ((b >> bit) & 1)
+                    table[b][k++] = static_cast<std::uint8_t>(bit);
+            }
+        }
+        return table;
+    }();
+
+  private:
+    std::vector<std::uint64_t> words;
+    std::size_t num_bits = 0;
+    std::size_t num_ones = 0;
+    // ones before block i, and the total at the end
+    std::vector<std::uint64_t> block_ranks;
+    // block of one i * SAMPLE_RATE
+    std::vector<std::uint32_t> select_samples;
+    // position of zero i * ZERO_SAMPLE_RATE
+    std::vector<std::uint32_t> zero_positions;
+};
+
+// Succinct trie in the level order unary degree sequence (LOUDS). The nodes are numbered breadth first, node i is
+// the i-th one of the bit vector and its children are the ones of the (i + 1)-th run that ends with a zero (the first
+// run "10" belongs to a virtual super root). Together with the characters and the leaf bits, this takes about 11.8
+// bits per node. The payloads (the state the engines keep per node) are stored in a separate array, so tries with
+// DummyPayload stay at this size. Built from the sorted words one level at a time, without an intermediate trie.
+// The node numbers and the LOUDS positions are 32 bit, so insert throws std::length_error for tries of more than
+// about 2^31 nodes.
+template <class PayloadType = DummyPayload, bool collect_stats = false> class LoudsTrie {
+
+  public:
+    using NodePtrType = std::uint32_t;
+    using ChildPtrIteratorType = std::uint32_t;
+    static const NodePtrType null = 0;
+    // payloads with num_children get the sizes of the subtrees while the trie is built (count_subtrees)
+    static constexpr bool counts_subtrees = SubtreeCountPayload<PayloadType>;
+
+  public:
+    LoudsTrie(std::size_t num_threads = std::thread::hardware_concurrency()) : num_threads(num_threads) {}
+
+    void insert(std::vector<std::string>& words) {
+        std::vector<std::string> sorted_words = words;
+        boost::sort::sample_sort(sorted_words.begin(), sorted_words.end(), num_threads);
+        sorted_words.erase(std::unique(sorted_words.begin(), sorted_words.end()), sorted_words.end());
+        insert_sorted(sorted_words);
+    }
+
+    // words must be sorted and unique
+    void insert_sorted(std::vector<std::string>& words) {
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("louds");
+        }
+
+        louds = RankSelectBitVector();
+        characters.assign(1, '\0');
+        leaves.assign(1, 0);
+        set_leaf(0, !words.empty() && words[0].empty());
+
+        // super root
+        louds.push_back(1);
+        louds.push_back(0);
+
+        // the words below each node of the current level share its prefix
+        std::vector<std::pair<std::size_t, std::size_t>> level = {{0, words.size()}};
+        std::vector<std::pair<std::size_t, std::size_t>> next_level;
+
+        for (std::size_t depth = 0; !level.empty(); depth++) {
+            next_level.clear();
+
+            for (auto [begin, end] : level) {
+                // the prefix itself comes first
+                if (begin < end && words[begin].size() == depth)
+                    begin++;
+
+                while (begin < end) {
+                    const char c = words[begin][depth];
+                    assert(c < 128 && c > 0);
+
+                    std::size_t group_end = begin + 1;
+                    while (group_end < end && words[group_end][depth] == c)
+                        group_end++;
+
+                    louds.push_back(1);
+                    characters.push_back(c);
+                    if (characters.size() % 64 == 1)
+                        leaves.push_back(0);
+                    set_leaf(characters.size() - 1, words[begin].size() == depth + 1);
+
+                    next_level.emplace_back(begin, group_end);
+                    begin = group_end;
+                }
+
+                louds.push_back(0);
+            }
+
+            std::swap(level, next_level);
+        }
+
+        if (characters.size() >= std::numeric_limits<NodePtrType>::max())
+            throw std::length_error("the trie has more nodes than a LoudsTrie can number");
+        louds.build();
+        // one shared payload if it holds no state
+        payloads.assign(std::is_empty_v<PayloadType> ? 1 : characters.size(), PayloadType());
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+        }
+
+        if constexpr (counts_subtrees) {
+            if constexpr (collect_stats) {
+                statistics_collector::get().start_measure("count_subtrees");
+            }
+            count_subtrees_backwards();
+            if constexpr (collect_stats) {
+                statistics_collector::get().stop_measure();
+            }
+        }
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().add_stat("bytes", std::to_string(get_memory_usage()));
+            statistics_collector::get().add_stat("bits_per_node",
+                                                 std::to_string(8.0 * get_memory_usage() / characters.size()));
+        }
+    }
+
+    NodePtrType get_root() {
+        return 0;
+    }
+
+    std::size_t get_num_nodes() {
+        return characters.size();
+    }
+
+    std::size_t get_index(NodePtrType node_ptr) {
+        return node_ptr;
+    }
+
+    bool is_leaf(NodePtrType node_ptr) {
+        return (leaves[node_ptr / 64] >> (node_ptr % 64)) & 1;
+    }
+
+    // the parent's run is the one the one of node_ptr is in
+    NodePtrType get_parent(NodePtrType node_ptr) {
+        if (node_ptr == 0)
+            return 0;
+        return static_cast<NodePtrType>(louds.rank0(louds.select1(node_ptr)) - 1);
+    }
+
+    char get_character(NodePtrType node_ptr) {
+        return characters[node_ptr];
+    }
+
+    PayloadType& get_payload(NodePtrType node_ptr) {
+        if constexpr (std::is_empty_v<PayloadType>)
+            return payloads[0];
+        return payloads[node_ptr];
+    }
+
+    // the run of node_ptr starts after its zero of the super root and the runs before, the first child is the
+    // number of ones before it
+    std::pair<ChildPtrIteratorType, ChildPtrIteratorType> get_child_iterator(NodePtrType node_ptr) {
+        const std::size_t begin = louds.select0(node_ptr) + 1;
+        const auto first_child = static_cast<ChildPtrIteratorType>(begin - node_ptr - 1);
+        return {first_child, first_child + static_cast<ChildPtrIteratorType>(louds.count_run_of_ones(begin))};
+    }
+
+    NodePtrType dereference_child_iterator(ChildPtrIteratorType it) {
+        return it;
+    }
+
+    std::string get_word(NodePtrType node_ptr) {
+        std::string result = "";
+
+        NodePtrType current = node_ptr;
+
+        while (current) {
+            result = characters[current] + result;
+            current = get_parent(current);
+        }
+
+        return result;
+    }
+
+    // bytes of the trie structure without the payloads
+    std::size_t get_memory_usage() const {
+        return louds.get_memory_usage() + characters.size() * sizeof(char) + leaves.size() * sizeof(std::uint64_t);
+    }
+
+  private:
+    void set_leaf(std::size_t node, bool leaf) {
+        leaves[node / 64] |= std::uint64_t(leaf) << (node % 64);
+    }
+
+    // The runs from the back, a zero ends the run of the previous node and a one is the previous child. Children
+    // have larger numbers than their parent, so their counts are final when they are added.
+    void count_subtrees_backwards() {
+        std::size_t node = characters.size();
+        std::size_t child = characters.size();
+
+        for (std::size_t position = louds.size(); position-- > 2;) {
+            if (!louds[position]) {
+                node--;
+            } else {
+                child--;
+                payloads[node].num_children += payloads[child].num_children + 1;
+            }
+        }
+    }
+
+  private:
+    RankSelectBitVector louds;
+    std::vector<char> characters;
+    // bit i % 64 of leaves[i / 64]
+    std::vector<std::uint64_t> leaves;
+    std::vector<PayloadType> payloads;
+
+    std::size_t num_threads;
+};
@@ -5,8 +5,11 @@
 #include <queue>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "implementation/bit_parallel_levenshtein.hpp"
+#include "implementation/cpu_dispatch.hpp"
 #include "implementation/levenshtein_penalty_functions.hpp"
 
 template <class PenaltyClass = levenshtein::KBDistance> class NaiveLevenshtein {
@@ -20,6 +23,9 @@ template <class PenaltyClass = levenshtein::KBDistance> class NaiveLevenshtein {
 
     std::vector<std::pair<float, std::string>> query(const std::string& query, std::size_t n) noexcept {
 
+        // unit costs are computed bit-parallel, the match masks of the query are shared by all words
+        const levenshtein::BitParallelPattern pattern(unit_costs ? query : "");
+
         std::priority_queue<std::pair<float, std::size_t>> q;
 #pragma omp parallel num_threads(num_threads), shared(q)
         {
@@ -28,7 +34,8 @@ template <class PenaltyClass = levenshtein::KBDistance> class NaiveLevenshtein {
 #pragma omp for
             for (std::size_t i = 0; i < _words.size(); i++) {
                 std::string& word = _words[i];
-                float dist = edit_distance(word, query);
+                float dist = cpu_dispatch::dispatch(
+                    [&]() { return unit_costs ? pattern.distance(word) : edit_distance(word, query); });
                 if (local_q.size() < n || dist < local_q.top().first) { // order matters here
                     local_q.emplace(dist, i);
                     if (local_q.size() > n)
@@ -62,6 +69,9 @@ template <class PenaltyClass = levenshtein::KBDistance> class NaiveLevenshtein {
     }
 
     inline float edit_distance(const std::string& word, const std::string& query) noexcept {
+        if constexpr (unit_costs)
+            return levenshtein::BitParallelPattern(query).distance(word);
+
         const std::size_t m = word.size();
         const std::size_t n = query.size();
 
@@ -91,6 +101,8 @@ template <class PenaltyClass = levenshtein::KBDistance> class NaiveLevenshtein {
     }
 
   private:
+    static constexpr bool unit_costs = std::is_same_v<PenaltyClass, levenshtein::UnitPenalty>;
+
     PenaltyClass penalty;
     std::size_t num_threads;
     std::vector<std::string> _words;
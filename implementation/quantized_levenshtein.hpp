@@ -0,0 +1,219 @@
+#pragma once
+
+#include "implementation/levenshtein_penalty_functions.hpp"
+#include "implementation/radix_trie.hpp"
+#include "implementation/trie.hpp"
+#include "implementation/trie_search.hpp"
+#include "implementation/vectorized_trie.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <smmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+template <class CellType> struct QuantizedTriePayload {
+    std::size_t num_children;
+    CellType min_distance;
+    CellType distance;
+};
+
+// Saturating SSE arithmetic on packed cells: 16 lanes of uint8_t or 8 lanes of uint16_t per register
+template <class CellType> struct SaturatingLanes;
+
+template <> struct SaturatingLanes<std::uint8_t> {
+    static constexpr std::size_t size = 16;
+    // fixed point scale of the costs: units per cost of 1
+    static constexpr float default_scale = 32.f;
+
+    static __m128i adds(__m128i a, __m128i b) {
+        return _mm_adds_epu8(a, b);
+    }
+    static __m128i min(__m128i a, __m128i b) {
+        return _mm_min_epu8(a, b);
+    }
+    static __m128i broadcast(std::uint8_t value) {
+        return _mm_set1_epi8(static_cast<char>(value));
+    }
+};
+
+template <> struct SaturatingLanes<std::uint16_t> {
+    static constexpr std::size_t size = 8;
+    static constexpr float default_scale = 2048.f;
+
+    static __m128i adds(__m128i a, __m128i b) {
+        return _mm_adds_epu16(a, b);
+    }
+    static __m128i min(__m128i a, __m128i b) {
+        return _mm_min_epu16(a, b);
+    }
+    static __m128i broadcast(std::uint16_t value) {
+        return _mm_set1_epi16(static_cast<short>(value));
+    }
+};
+
+// AcceleratedLevenshtein with fixed point costs: the penalties are scaled by `scale` and rounded to CellType, and the
+// dp saturates at the largest CellType instead of overflowing. Smaller cells fit more lanes into a register and
+// shrink the dp rows (by 2 for uint16_t and 4 for uint8_t), at the price of rounding errors of up to 0.5 / scale per
+// edit. Distances beyond max CellType / scale all compare equal.
+//
+// The terms that come from the parent row (insert, modify) are computed for a whole register at once, the remove
+// chain within the child row is resolved in a second, scalar pass. Tries with edge runs (RadixTrie) are rejected, a
+// child row is computed for a single character.
+template <class PenaltyClass = levenshtein::KBDistance, class CellType = std::uint16_t,
+          class ParallelTrieImpl = VectorizedParallelTrie<QuantizedTriePayload<CellType>>, bool early_break = true,
+          bool collect_stats = false>
+    requires(!EdgeTrie<ParallelTrieImpl>)
+class QuantizedLevenshtein {
+
+  private:
+    using NodePtrType = typename ParallelTrieImpl::NodePtrType;
+    using ChildPtrIteratorType = typename ParallelTrieImpl::ChildPtrIteratorType;
+    using Lanes = SaturatingLanes<CellType>;
+
+    static_assert(std::is_unsigned_v<CellType>, "cells must be unsigned for saturating arithmetic");
+    static constexpr int CHAR_SIZE = 128;
+
+  public:
+    QuantizedLevenshtein(PenaltyClass penalty, std::size_t num_threads = std::thread::hardware_concurrency(),
+                         float scale = Lanes::default_scale)
+        : penalty(penalty), num_threads(num_threads), scale(scale), trie(num_threads) {
+        for (int c = 0; c < CHAR_SIZE; c++) {
+            insert_costs[c] = quantize(this->penalty.insert(static_cast<char>(c)));
+        }
+    }
+
+    void precompute(std::vector<std::string>& words) noexcept {
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("insert");
+        }
+        trie.insert(words);
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+        }
+
+        if constexpr (early_break) {
+            if constexpr (collect_stats) {
+                statistics_collector::get().start_measure("compute_children");
+            }
+            count_subtrees(trie, num_threads);
+            if constexpr (collect_stats) {
+                statistics_collector::get().stop_measure();
+            }
+        }
+    }
+
+    inline void calculate_children(const NodePtrType& node, const std::size_t m) {
+
+        const std::size_t row_size = m + 1;
+        const CellType* parent = &dp[trie.get_index(node) * row_size];
+
+        ChildPtrIteratorType it;
+        ChildPtrIteratorType end;
+        std::tie(it, end) = trie.get_child_iterator(node);
+
+        for (; it != end; it++) {
+            NodePtrType child = trie.dereference_child_iterator(it);
+
+            const char character = trie.get_character(child);
+            const CellType insert_penalty = insert_costs[static_cast<unsigned char>(character) % CHAR_SIZE];
+            const CellType* modify = &modify_profile[(static_cast<unsigned char>(character) % CHAR_SIZE) * row_size];
+            CellType* row = &dp[trie.get_index(child) * row_size];
+
+            // insert and modify
+            const __m128i insert = Lanes::broadcast(insert_penalty);
+            row[0] = saturating_add(parent[0], insert_penalty);
+
+            std::size_t i = 1;
+            for (; i + Lanes::size <= row_size; i += Lanes::size) {
+                const __m128i from_parent = Lanes::adds(load(parent + i), insert);
+                const __m128i from_diagonal = Lanes::adds(load(parent + i - 1), load(modify + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), Lanes::min(from_parent, from_diagonal));
+            }
+            for (; i < row_size; i++) {
+                row[i] = std::min(saturating_add(parent[i], insert_penalty), saturating_add(parent[i - 1], modify[i]));
+            }
+
+            // remove
+            CellType min = row[0];
+            for (i = 1; i < row_size; i++) {
+                row[i] = std::min(row[i], saturating_add(row[i - 1], remove_costs[i]));
+                min = std::min(min, row[i]);
+            }
+
+            trie.get_payload(child).min_distance = min;
+            trie.get_payload(child).distance = row[m];
+        }
+    }
+
+    // units per cost of 1, every edit may be off by 0.5 / scale
+    float get_scale() const {
+        return scale;
+    }
+
+    std::vector<std::pair<float, std::string>> query(const std::string& query, const std::size_t n) noexcept {
+        prepare_query(query);
+
+        auto nodes = search_trie<ParallelTrieImpl, early_break, collect_stats>(
+            trie, n, num_threads, [&](const NodePtrType& node) { calculate_children(node, query.size()); });
+
+        std::vector<std::pair<float, std::string>> result(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            result[i] = std::make_pair(nodes[i].first / scale, trie.get_word(nodes[i].second));
+        }
+        return result;
+    }
+
+  private:
+    CellType quantize(const float cost) const {
+        return static_cast<CellType>(
+            std::min<float>(std::round(cost * scale), static_cast<float>(std::numeric_limits<CellType>::max())));
+    }
+
+    static __m128i load(const CellType* cells) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells));
+    }
+
+    static CellType saturating_add(const CellType a, const CellType b) {
+        const unsigned int sum = static_cast<unsigned int>(a) + b;
+        return static_cast<CellType>(std::min<unsigned int>(sum, std::numeric_limits<CellType>::max()));
+    }
+
+    // profiles of the query (one cost per column) and the row of the root
+    void prepare_query(const std::string& query) {
+        const std::size_t row_size = query.size() + 1;
+
+        remove_costs.assign(row_size, 0);
+        modify_profile.assign(CHAR_SIZE * row_size, 0);
+        for (std::size_t i = 1; i < row_size; i++) {
+            remove_costs[i] = quantize(penalty.remove(query[i - 1]));
+
+            for (int c = 1; c < CHAR_SIZE; c++) {
+                modify_profile[c * row_size + i] = quantize(penalty.modify(static_cast<char>(c), query[i - 1]));
+            }
+        }
+
+        dp.resize(trie.get_num_nodes() * row_size);
+        dp[0] = 0;
+        for (std::size_t i = 1; i < row_size; i++) {
+            dp[i] = saturating_add(dp[i - 1], remove_costs[i]);
+        }
+    }
+
+  private:
+    alignas(CACHE_LINE_SIZE) const PenaltyClass penalty;
+    alignas(CACHE_LINE_SIZE) const std::size_t num_threads;
+    const float scale;
+    alignas(CACHE_LINE_SIZE) ParallelTrieImpl trie;
+    alignas(CACHE_LINE_SIZE) std::vector<CellType> dp;
+
+    CellType insert_costs[CHAR_SIZE];
+    std::vector<CellType> remove_costs;
+    std::vector<CellType> modify_profile;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "implementation/levenshtein_penalty_functions.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace levenshtein {
+
+// Per position a small set of alternative characters the user may have meant, each with an additional cost
+using KeystrokeLattice = std::vector<std::vector<std::pair<char, float>>>;
+
+// Builds a lattice for tapped keys: every tap may also have been one of the `alternatives` closest keys, at the
+// keyboard distance of the two keys.
+inline KeystrokeLattice keyboard_lattice(const std::string& taps, const KBDistance& keyboard,
+                                         const std::size_t alternatives) {
+    KeystrokeLattice lattice(taps.size());
+
+    for (std::size_t i = 0; i < taps.size(); i++) {
+        lattice[i].emplace_back(taps[i], 0.f);
+
+        for (auto& neighbour : keyboard.neighbours(taps[i], alternatives)) {
+            lattice[i].push_back(neighbour);
+        }
+    }
+
+    return lattice;
+}
+
+} // namespace levenshtein
+
+// Query costs that do not depend on the trie, precomputed per column (column i belongs to query position i).
+// Query types that are not a plain string are expressed as a profile and share a single dp kernel.
+struct QueryProfile {
+    static constexpr int CHAR_SIZE = 128;
+
+    std::size_t size = 0;
+    // modify[character * size + i]: cost of aligning character with position i
+    std::vector<float> modify;
+    // remove[i]: cost of skipping position i
+    std::vector<float> remove;
+    // insert_scale[i]: factor of the insert penalty while at position i, 0 where a position absorbs characters
+    std::vector<float> insert_scale;
+
+    // The modify (remove) cost of a position is the cheapest of its alternatives, including the alternative's cost
+    template <class PenaltyClass>
+    static QueryProfile from_lattice(const PenaltyClass& penalty, const levenshtein::KeystrokeLattice& lattice) {
+        QueryProfile profile;
+        profile.size = lattice.size();
+        profile.modify.assign(CHAR_SIZE * profile.size, std::numeric_limits<float>().max());
+        profile.remove.assign(profile.size, std::numeric_limits<float>().max());
+        profile.insert_scale.assign(profile.size, 1.f);
+
+        for (std::size_t i = 0; i < profile.size; i++) {
+            for (const auto& [alternative, cost] : lattice[i]) {
+                profile.remove[i] = std::min(profile.remove[i], cost + penalty.remove(alternative));
+
+                for (int c = 1; c < CHAR_SIZE; c++) {
+                    float& modify = profile.modify[c * profile.size + i];
+                    modify = std::min(modify, cost + penalty.modify(static_cast<char>(c), alternative));
+                }
+            }
+        }
+
+        return profile;
+    }
+
+    // '?' matches any single character for free, '*' matches any (possibly empty) run of characters for free. All
+    // other characters are compared with the penalty like a plain query.
+    template <class PenaltyClass>
+    static QueryProfile from_pattern(const PenaltyClass& penalty, const std::string& pattern) {
+        QueryProfile profile;
+        profile.size = pattern.size();
+        profile.modify.resize(CHAR_SIZE * profile.size);
+        profile.remove.resize(profile.size);
+        profile.insert_scale.assign(profile.size, 1.f);
+
+        for (std::size_t i = 0; i < profile.size; i++) {
+            const bool any = pattern[i] == '?' || pattern[i] == '*';
+
+            profile.remove[i] = pattern[i] == '*' ? 0.f : penalty.remove(pattern[i]);
+            profile.insert_scale[i] = pattern[i] == '*' ? 0.f : 1.f;
+
+            for (int c = 1; c < CHAR_SIZE; c++) {
+                profile.modify[c * profile.size + i] = any ? 0.f : penalty.modify(static_cast<char>(c), pattern[i]);
+            }
+        }
+
+        return profile;
+    }
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "implementation/trie.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Tries whose edges hold runs of characters. get_edge(node) returns the run on the edge from the parent to node,
+// get_character(node) its first character.
+template <class TrieImpl>
+concept EdgeTrie = requires(TrieImpl trie, typename TrieImpl::NodePtrType node) { trie.get_edge(node); };
+
+// Path compressed (radix) trie with the interface of VectorizedParallelTrie. Chains of nodes with a single child
+// that are not the end of a word are merged into one edge, so only the root, the ends of words and branching nodes
+// remain. Children have consecutive indices.
+template <class PayloadType = DummyPayload, bool collect_stats = false> class RadixTrie {
+
+  public:
+    struct RadixTrieNode {
+        friend RadixTrie;
+
+      private:
+        bool leaf;
+        // must be 0 for root
+        std::size_t parent;
+        PayloadType payload;
+
+        std::size_t children_begin_index;
+        std::size_t children_end_index;
+
+        // the run of the edge from the parent is edges[edge_begin, edge_begin + edge_length)
+        std::size_t edge_begin;
+        std::uint32_t edge_length;
+    };
+
+  private:
+    using HelperType = ParallelTrie<DummyPayload>;
+    using HelperNodePtrType = typename HelperType::NodePtrType;
+    using NodeType = RadixTrieNode;
+
+  public:
+    using NodePtrType = std::size_t;
+    using ChildPtrIteratorType = std::size_t;
+    static const NodePtrType null = 0;
+
+  public:
+    RadixTrie(std::size_t num_threads = std::thread::hardware_concurrency()) : num_threads(num_threads) {}
+
+    void insert(std::vector<std::string>& words) {
+        HelperType helper(num_threads);
+        helper.insert(words);
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("compress");
+        }
+
+        nodes.clear();
+        edges.clear();
+        nodes.reserve(helper.get_num_nodes());
+        edges.reserve(helper.get_num_nodes());
+
+        nodes.emplace_back();
+        nodes[0].leaf = false;
+        nodes[0].parent = 0;
+        nodes[0].edge_begin = 0;
+        nodes[0].edge_length = 0;
+
+        // breadth first, so the children of a node get consecutive indices
+        std::queue<std::pair<HelperNodePtrType, std::size_t>> queue;
+        queue.emplace(helper.get_root(), 0);
+
+        while (!queue.empty()) {
+            auto [helper_node, index] = queue.front();
+            queue.pop();
+
+            nodes[index].children_begin_index = nodes.size();
+
+            auto iters = helper.get_child_iterator(helper_node);
+            for (auto it = iters.first; it != iters.second; it++) {
+                HelperNodePtrType current = helper.dereference_child_iterator(it);
+
+                NodeType child;
+                child.parent = index;
+                child.edge_begin = edges.size();
+                edges.push_back(helper.get_character(current));
+
+                // follow the chain
+                while (!helper.is_leaf(current) && has_single_child(helper, current)) {
+                    auto chain = helper.get_child_iterator(current);
+                    current = helper.dereference_child_iterator(chain.first);
+                    edges.push_back(helper.get_character(current));
+                }
+
+                child.edge_length = static_cast<std::uint32_t>(edges.size() - child.edge_begin);
+                child.leaf = helper.is_leaf(current);
+
+                queue.emplace(current, nodes.size());
+                nodes.push_back(child);
+            }
+
+            nodes[index].children_end_index = nodes.size();
+        }
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+            statistics_collector::get().add_stat("compressed_nodes", std::to_string(nodes.size()));
+        }
+    }
+
+    NodePtrType get_root() {
+        return 0;
+    }
+
+    std::size_t get_num_nodes() {
+        return nodes.size();
+    }
+
+    std::size_t get_index(NodePtrType node_ptr) {
+        return node_ptr;
+    }
+
+    bool is_leaf(NodePtrType node_ptr) {
+        return nodes[node_ptr].leaf;
+    }
+
+    NodePtrType get_parent(NodePtrType node_ptr) {
+        return nodes[node_ptr].parent;
+    }
+
+    char get_character(NodePtrType node_ptr) {
+        return edges[nodes[node_ptr].edge_begin];
+    }
+
+    // run of characters on the edge from the parent, (begin, length)
+    std::pair<const char*, std::size_t> get_edge(NodePtrType node_ptr) {
+        return {&edges[nodes[node_ptr].edge_begin], nodes[node_ptr].edge_length};
+    }
+
+    PayloadType& get_payload(NodePtrType node_ptr) {
+        return nodes[node_ptr].payload;
+    }
+
+    std::pair<ChildPtrIteratorType, ChildPtrIteratorType> get_child_iterator(NodePtrType node_ptr) {
+        return {nodes[node_ptr].children_begin_index, nodes[node_ptr].children_end_index};
+    }
+
+    NodePtrType dereference_child_iterator(ChildPtrIteratorType it) {
+        return it;
+    }
+
+    std::string get_word(NodePtrType node_ptr) {
+        std::string result = "";
+
+        NodePtrType current = node_ptr;
+
+        while (current) {
+            result = std::string(&edges[nodes[current].edge_begin], nodes[current].edge_length) + result;
+            current = nodes[current].parent;
+        }
+
+        return result;
+    }
+
+  private:
+    static bool has_single_child(HelperType& helper, HelperNodePtrType node) {
+        auto iters = helper.get_child_iterator(node);
+        if (iters.first == iters.second)
+            return false;
+        return ++iters.first == iters.second;
+    }
+
+  private:
+    std::vector<NodeType> nodes;
+    std::vector<char> edges;
+    std::size_t num_threads;
+};
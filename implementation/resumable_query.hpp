@@ -0,0 +1,192 @@
+#pragma once
+
+#include "implementation/levenshtein_penalty_functions.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Best-first search over the trie that can be continued after it returned results. The frontier (nodes that were
+// not expanded yet, together with their dp row and lower bound) is kept alive between calls to next(), so fetching
+// the next page only expands the nodes the previous pages did not need.
+//
+// The handle references the trie and penalty of the engine that created it: the engine must outlive the handle and
+// must not be re-precomputed in the meantime.
+template <class PenaltyClass, class TrieImpl> class ResumableQuery {
+
+  private:
+    using NodePtrType = typename TrieImpl::NodePtrType;
+    using ChildPtrIteratorType = typename TrieImpl::ChildPtrIteratorType;
+
+    // lower bound / distance, node, row slot
+    using Entry = std::tuple<float, NodePtrType, std::size_t>;
+    using MinQueue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+    // number of frontier nodes expanded per thread and round
+    static constexpr std::size_t BATCH_PER_THREAD = 32;
+    static constexpr std::size_t NO_ROW = std::numeric_limits<std::size_t>::max();
+
+  public:
+    ResumableQuery(TrieImpl& trie, const PenaltyClass& penalty, const std::string& query,
+                   std::size_t num_threads = std::thread::hardware_concurrency())
+        : trie(trie), penalty(penalty), query(query), row_size(query.size() + 1), num_threads(num_threads) {
+
+        std::size_t root_row = allocate_row();
+        float* row = &rows[root_row * row_size];
+
+        row[0] = 0;
+        for (std::size_t i = 1; i < row_size; i++) {
+            row[i] = row[i - 1] + penalty.remove(query[i - 1]);
+        }
+
+        // the root row starts at 0, so its minimum is 0 as well
+        frontier.emplace(0.f, trie.get_root(), root_row);
+    }
+
+    // Returns the next k results, continuing where the previous call stopped. Results are ordered by distance and
+    // the concatenation of all pages equals a single query with the summed up n (up to the order of equal distances).
+    std::vector<std::pair<float, std::string>> next(const std::size_t k) noexcept {
+        std::vector<std::pair<float, std::string>> result;
+        result.reserve(k);
+
+        while (result.size() < k) {
+            // A candidate is final if no unexplored subtree can contain a better word
+            while (!candidates.empty() && result.size() < k &&
+                   (frontier.empty() || std::get<0>(candidates.top()) <= std::get<0>(frontier.top()))) {
+                result.emplace_back(std::get<0>(candidates.top()), trie.get_word(std::get<1>(candidates.top())));
+                candidates.pop();
+            }
+
+            if (result.size() == k || frontier.empty())
+                break;
+
+            expand_batch();
+        }
+
+        return result;
+    }
+
+    // true if all words of the dictionary were returned
+    bool done() const noexcept {
+        return frontier.empty() && candidates.empty();
+    }
+
+    std::size_t frontier_size() const noexcept {
+        return frontier.size();
+    }
+
+  private:
+    void expand_batch() {
+        // POP BATCH -----------------------------
+        std::vector<Entry> batch;
+        const std::size_t max_batch = std::max<std::size_t>(1, num_threads * BATCH_PER_THREAD);
+
+        while (!frontier.empty() && batch.size() < max_batch) {
+            batch.push_back(frontier.top());
+            frontier.pop();
+        }
+
+        // ALLOCATE CHILD ROWS -------------------
+        // rows are handed out sequentially, the dp itself is computed in parallel
+        std::vector<std::size_t> first_child(batch.size() + 1, 0);
+        for (std::size_t b = 0; b < batch.size(); b++) {
+            first_child[b + 1] = first_child[b];
+
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType end;
+            for (std::tie(it, end) = trie.get_child_iterator(std::get<1>(batch[b])); it != end; it++) {
+                first_child[b + 1]++;
+            }
+        }
+
+        std::vector<Entry> children(first_child.back());
+        for (Entry& child : children) {
+            std::get<2>(child) = allocate_row();
+        }
+
+        // COMPUTE ROWS --------------------------
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 4) if (batch.size() > num_threads)
+        for (std::size_t b = 0; b < batch.size(); b++) {
+            const float* parent_row = &rows[std::get<2>(batch[b]) * row_size];
+
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType end;
+            std::tie(it, end) = trie.get_child_iterator(std::get<1>(batch[b]));
+
+            for (std::size_t c = first_child[b]; it != end; it++, c++) {
+                NodePtrType child = trie.dereference_child_iterator(it);
+                std::get<1>(children[c]) = child;
+                std::get<0>(children[c]) =
+                    calculate_row(parent_row, &rows[std::get<2>(children[c]) * row_size], trie.get_character(child));
+            }
+        }
+
+        // UPDATE FRONTIER -----------------------
+        for (const Entry& parent : batch) {
+            free_rows.push_back(std::get<2>(parent));
+        }
+
+        for (const Entry& child : children) {
+            NodePtrType node = std::get<1>(child);
+            std::size_t row = std::get<2>(child);
+
+            if (trie.is_leaf(node)) {
+                candidates.emplace(rows[row * row_size + row_size - 1], node, NO_ROW);
+            }
+
+            auto iters = trie.get_child_iterator(node);
+            if (iters.first != iters.second) {
+                frontier.push(child);
+            } else {
+                free_rows.push_back(row);
+            }
+        }
+    }
+
+    // returns the minimum of the new row, which bounds every word below the child
+    inline float calculate_row(const float* parent_row, float* child_row, const char character) const {
+        const float insert_penalty = penalty.insert(character);
+
+        float min = child_row[0] = parent_row[0] + insert_penalty;
+
+        for (std::size_t i = 1; i < row_size; i++) {
+            child_row[i] = std::min(std::min(parent_row[i] + insert_penalty,
+                                             child_row[i - 1] + penalty.remove(query[i - 1])),
+                                    parent_row[i - 1] + penalty.modify(character, query[i - 1]));
+            min = std::min(min, child_row[i]);
+        }
+
+        return min;
+    }
+
+    std::size_t allocate_row() {
+        if (!free_rows.empty()) {
+            std::size_t row = free_rows.back();
+            free_rows.pop_back();
+            return row;
+        }
+
+        rows.resize(rows.size() + row_size);
+        return rows.size() / row_size - 1;
+    }
+
+  private:
+    TrieImpl& trie;
+    const PenaltyClass& penalty;
+    const std::string query;
+    const std::size_t row_size;
+    const std::size_t num_threads;
+
+    // nodes with unexplored children, ordered by the minimum of their row
+    MinQueue frontier;
+    // leaves that were reached but not returned yet, ordered by distance
+    MinQueue candidates;
+
+    std::vector<float> rows;
+    std::vector<std::size_t> free_rows;
+};
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "implementation/levenshtein_penalty_functions.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Best-first search for the best decompositions of a query into up to max_words dictionary words. When the dp reaches
+// a leaf, the search may restart at the root with the row of the leaf carried over, so the next word continues to
+// align the query where the previous word stopped. A single traversal therefore covers all split points.
+//
+// Each additional word costs split_penalty, a space in the query is free between two words.
+template <class PenaltyClass, class TrieImpl> class SegmentationSearch {
+
+  private:
+    using NodePtrType = typename TrieImpl::NodePtrType;
+    using ChildPtrIteratorType = typename TrieImpl::ChildPtrIteratorType;
+
+    struct State {
+        NodePtrType node;
+        // number of completed words before node
+        std::size_t words;
+        // last completed word (index into segments), NO_SEGMENT for the first word
+        std::size_t segment;
+        std::size_t row;
+    };
+
+    // completed word and the word before it, decompositions share their common beginning
+    struct Segment {
+        NodePtrType leaf;
+        std::size_t previous;
+    };
+
+    // lower bound, insertion counter (keeps the queue order deterministic), state
+    using Entry = std::tuple<float, std::size_t, State>;
+    struct EntryGreater {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return std::tie(std::get<0>(a), std::get<1>(a)) > std::tie(std::get<0>(b), std::get<1>(b));
+        }
+    };
+
+    static constexpr std::size_t BATCH_PER_THREAD = 32;
+    static constexpr std::size_t NO_SEGMENT = std::numeric_limits<std::size_t>::max();
+
+  public:
+    SegmentationSearch(TrieImpl& trie, const PenaltyClass& penalty, const std::string& query,
+                       const std::size_t max_words, const float split_penalty,
+                       const std::size_t num_threads = std::thread::hardware_concurrency())
+        : trie(trie), penalty(penalty), query(query), row_size(query.size() + 1), max_words(max_words),
+          split_penalty(split_penalty), num_threads(num_threads) {}
+
+    std::vector<std::pair<float, std::string>> run(const std::size_t n) {
+        std::vector<std::pair<float, std::string>> result;
+
+        std::size_t root_row = allocate_row();
+        float* row = &rows[root_row * row_size];
+        row[0] = 0;
+        for (std::size_t i = 1; i < row_size; i++) {
+            row[i] = row[i - 1] + penalty.remove(query[i - 1]);
+        }
+        push_frontier(0.f, State{trie.get_root(), 0, NO_SEGMENT, root_row});
+
+        while (result.size() < n) {
+            // a decomposition is final if no unexplored state can lead to a better one
+            while (!candidates.empty() && result.size() < n &&
+                   (frontier.empty() || candidates.top().first <= std::get<0>(frontier.top()))) {
+                result.emplace_back(candidates.top().first, get_words(candidates.top().second));
+                candidates.pop();
+            }
+
+            if (result.size() == n || frontier.empty())
+                break;
+
+            expand_batch();
+        }
+
+        return result;
+    }
+
+  private:
+    void expand_batch() {
+        // POP BATCH -----------------------------
+        std::vector<State> batch;
+        const std::size_t max_batch = std::max<std::size_t>(1, num_threads * BATCH_PER_THREAD);
+
+        while (!frontier.empty() && batch.size() < max_batch) {
+            batch.push_back(std::get<2>(frontier.top()));
+            frontier.pop();
+        }
+
+        // ALLOCATE CHILD ROWS -------------------
+        std::vector<std::size_t> first_child(batch.size() + 1, 0);
+        for (std::size_t b = 0; b < batch.size(); b++) {
+            first_child[b + 1] = first_child[b];
+
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType end;
+            for (std::tie(it, end) = trie.get_child_iterator(batch[b].node); it != end; it++) {
+                first_child[b + 1]++;
+            }
+        }
+
+        std::vector<State> children(first_child.back());
+        std::vector<float> bounds(children.size());
+        for (State& child : children) {
+            child.row = allocate_row();
+        }
+
+        // COMPUTE ROWS --------------------------
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 4) if (batch.size() > num_threads)
+        for (std::size_t b = 0; b < batch.size(); b++) {
+            const float* parent_row = &rows[batch[b].row * row_size];
+
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType end;
+            std::tie(it, end) = trie.get_child_iterator(batch[b].node);
+
+            for (std::size_t c = first_child[b]; it != end; it++, c++) {
+                NodePtrType child = trie.dereference_child_iterator(it);
+                children[c] = State{child, batch[b].words, batch[b].segment, children[c].row};
+                bounds[c] = calculate_row(parent_row, &rows[children[c].row * row_size], trie.get_character(child));
+            }
+        }
+
+        // UPDATE FRONTIER -----------------------
+        for (const State& parent : batch) {
+            free_rows.push_back(parent.row);
+        }
+
+        for (std::size_t c = 0; c < children.size(); c++) {
+            const State& child = children[c];
+            const float* row = &rows[child.row * row_size];
+
+            if (trie.is_leaf(child.node)) {
+                segments.push_back(Segment{child.node, child.segment});
+                const std::size_t segment = segments.size() - 1;
+
+                candidates.emplace(row[row_size - 1], segment);
+
+                // continue with the next word at the root
+                if (child.words + 1 < max_words) {
+                    std::size_t restart_row = allocate_row();
+                    // allocate_row may have moved the rows
+                    row = &rows[child.row * row_size];
+                    float* restart = &rows[restart_row * row_size];
+
+                    float min = restart[0] = row[0] + split_penalty;
+                    for (std::size_t i = 1; i < row_size; i++) {
+                        const float remove = query[i - 1] == ' ' ? 0.f : penalty.remove(query[i - 1]);
+                        restart[i] = std::min(row[i] + split_penalty, restart[i - 1] + remove);
+                        min = std::min(min, restart[i]);
+                    }
+
+                    push_frontier(min, State{trie.get_root(), child.words + 1, segment, restart_row});
+                }
+            }
+
+            auto iters = trie.get_child_iterator(child.node);
+            if (iters.first != iters.second) {
+                push_frontier(bounds[c], child);
+            } else {
+                free_rows.push_back(child.row);
+            }
+        }
+    }
+
+    // returns the minimum of the new row, which bounds every decomposition that continues below the child
+    inline float calculate_row(const float* parent_row, float* child_row, const char character) const {
+        const float insert_penalty = penalty.insert(character);
+
+        float min = child_row[0] = parent_row[0] + insert_penalty;
+
+        for (std::size_t i = 1; i < row_size; i++) {
+            child_row[i] = std::min(std::min(parent_row[i] + insert_penalty,
+                                             child_row[i - 1] + penalty.remove(query[i - 1])),
+                                    parent_row[i - 1] + penalty.modify(character, query[i - 1]));
+            min = std::min(min, child_row[i]);
+        }
+
+        return min;
+    }
+
+    void push_frontier(const float bound, const State& state) {
+        frontier.emplace(bound, push_counter++, state);
+    }
+
+    std::string get_words(std::size_t segment) {
+        std::string result = "";
+
+        while (segment != NO_SEGMENT) {
+            result = trie.get_word(segments[segment].leaf) + (result.empty() ? "" : " ") + result;
+            segment = segments[segment].previous;
+        }
+
+        return result;
+    }
+
+    std::size_t allocate_row() {
+        if (!free_rows.empty()) {
+            std::size_t row = free_rows.back();
+            free_rows.pop_back();
+            return row;
+        }
+
+        rows.resize(rows.size() + row_size);
+        return rows.size() / row_size - 1;
+    }
+
+  private:
+    TrieImpl& trie;
+    const PenaltyClass& penalty;
+    const std::string& query;
+    const std::size_t row_size;
+    const std::size_t max_words;
+    const float split_penalty;
+    const std::size_t num_threads;
+
+    std::priority_queue<Entry, std::vector<Entry>, EntryGreater> frontier;
+    std::size_t push_counter = 0;
+    // score, last segment of the decomposition
+    std::priority_queue<std::pair<float, std::size_t>, std::vector<std::pair<float, std::size_t>>,
+                        std::greater<std::pair<float, std::size_t>>>
+        candidates;
+
+    std::vector<Segment> segments;
+    std::vector<float> rows;
+    std::vector<std::size_t> free_rows;
+};
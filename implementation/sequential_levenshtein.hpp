@@ -6,9 +6,11 @@
 #include <string>
 #include <vector>
 
+#include "implementation/cpu_dispatch.hpp"
 #include "implementation/levenshtein_penalty_functions.hpp"
 
-template <class PenaltyClass = levenshtein::KBDistance> class SequentialLevenshtein {
+// set transpositions to true to also allow swapping two adjacent characters (optimal string alignment distance)
+template <class PenaltyClass = levenshtein::KBDistance, bool transpositions = false> class SequentialLevenshtein {
   public:
     SequentialLevenshtein(PenaltyClass penalty) : penalty(penalty) {}
 
@@ -22,7 +24,7 @@ template <class PenaltyClass = levenshtein::KBDistance> class SequentialLevensht
 
         for (std::size_t i = 0; i < _words.size(); i++) {
             std::string& word = _words[i];
-            float dist = edit_distance(word, query);
+            float dist = cpu_dispatch::dispatch([&]() { return edit_distance(word, query); });
             if (q.size() < n || dist < q.top().first) { // order matters here
                 q.emplace(dist, i);
                 if (q.size() > n)
@@ -63,6 +65,11 @@ template <class PenaltyClass = levenshtein::KBDistance> class SequentialLevensht
                 dp[i][j] = std::min(
                     std::min(dp[i - 1][j] + penalty.insert(word[i - 1]), dp[i][j - 1] + penalty.remove(query[j - 1])),
                     dp[i - 1][j - 1] + penalty.modify(word[i - 1], query[j - 1]));
+
+                if constexpr (transpositions) {
+                    if (i > 1 && j > 1 && word[i - 1] == query[j - 2] && word[i - 2] == query[j - 1])
+                        dp[i][j] = std::min(dp[i][j], dp[i - 2][j - 2] + penalty.transpose(word[i - 2], word[i - 1]));
+                }
             }
         }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "implementation/arena.hpp"
 #include "implementation/concurrent_container.hpp"
 #include "implementation/trie.hpp"
 
@@ -17,22 +18,15 @@
 template <class PayloadType = DummyPayload> class SequentialTrie {
 
   public:
+    // The nodes and their arrays of children live in the arena of the trie and are freed with it, without visiting
+    // them.
     struct SequentialTrieNode {
         friend SequentialTrie;
 
         static constexpr int CHAR_SIZE = 128;
 
         SequentialTrieNode(SequentialTrieNode* parent, char character)
-            : leaf(false), parent(parent), character(character), children(CHAR_SIZE) {
-            for (int i = 0; i < CHAR_SIZE; i++)
-                children[i] = nullptr;
-        }
-
-        ~SequentialTrieNode() {
-            for (SequentialTrieNode* child : children) {
-                delete child;
-            }
-        }
+            : leaf(false), parent(parent), character(character), children(nullptr), num_children(0) {}
 
       private:
         // can only be changed to true -> no atomic needed
@@ -42,8 +36,9 @@ template <class PayloadType = DummyPayload> class SequentialTrie {
         const char character;
         PayloadType payload;
 
-        // may be deleted, and set to nullptr
-        std::vector<SequentialTrieNode*> children;
+        // while building a table of CHAR_SIZE entries (or nullptr), afterwards the num_children children
+        SequentialTrieNode** children;
+        std::size_t num_children;
         std::size_t index;
     };
 
@@ -52,26 +47,28 @@ template <class PayloadType = DummyPayload> class SequentialTrie {
 
   public:
     using NodePtrType = NodeType*;
-    using ChildPtrIteratorType = typename std::vector<SequentialTrieNode*>::const_iterator;
+    using ChildPtrIteratorType = SequentialTrieNode* const*;
     NodePtrType null = nullptr;
 
   public:
-    SequentialTrie() : root(new SequentialTrieNode(nullptr, '\0')), num_nodes(1) {}
+    SequentialTrie() : root(arena.make<SequentialTrieNode>(nullptr, '\0')), num_nodes(1) {}
 
     SequentialTrie([[maybe_unused]] std::size_t num_threads) : SequentialTrie() {}
 
-    ~SequentialTrie() {
-        delete root;
-    }
-
     void insert(std::vector<std::string>& words) {
 
         // BUILD TRIE -----------------------------
+        // the tables of the build are released after the compression
+        Arena table_arena;
+
         for (std::string& word : words) {
             NodeType* current = root;
 
             for (std::size_t j = 0; j < word.size(); j++) {
 
+                if (current->children == nullptr)
+                    current->children = table_arena.make_array<NodePtrType>(NodeType::CHAR_SIZE);
+
                 NodePtrType& child = current->children[static_cast<int>(word[j])];
 
                 // maybe a string containes special characters that do not
@@ -81,7 +78,7 @@ template <class PayloadType = DummyPayload> class SequentialTrie {
                 // static_cast<int>(word[j]) << "\n";
 
                 if (child == nullptr) {
-                    child = new SequentialTrieNode(current, word[j]);
+                    child = arena.make<SequentialTrieNode>(current, word[j]);
                     num_nodes++;
                 }
 
@@ -106,15 +103,20 @@ template <class PayloadType = DummyPayload> class SequentialTrie {
             current->index = index_ctr++;
 
             // compress children
-            std::vector<NodePtrType> compressed_children;
-            for (std::size_t i = 0; i < current->children.size(); i++) {
-                if (current->children[i] != nullptr) {
-                    compressed_children.emplace_back(current->children[i]);
-                    q.push(current->children[i]);
+            if (current->children == nullptr)
+                continue;
+
+            NodePtrType* table = current->children;
+            for (int i = 0; i < NodeType::CHAR_SIZE; i++)
+                current->num_children += table[i] != nullptr;
+
+            current->children = arena.make_array<NodePtrType>(current->num_children);
+            for (int i = 0, j = 0; i < NodeType::CHAR_SIZE; i++) {
+                if (table[i] != nullptr) {
+                    current->children[j++] = table[i];
+                    q.push(table[i]);
                 }
             }
-
-            current->children = std::move(compressed_children);
         }
     }
 
@@ -148,7 +150,7 @@ template <class PayloadType = DummyPayload> class SequentialTrie {
     }
 
     std::pair<ChildPtrIteratorType, ChildPtrIteratorType> get_child_iterator(NodePtrType node_ptr) {
-        return {node_ptr->children.begin(), node_ptr->children.end()};
+        return {node_ptr->children, node_ptr->children + node_ptr->num_children};
     }
 
     NodePtrType dereference_child_iterator(ChildPtrIteratorType it) {
@@ -169,6 +171,7 @@ template <class PayloadType = DummyPayload> class SequentialTrie {
     }
 
   private:
+    Arena arena;
     NodePtrType root;
     std::size_t num_threads;
     std::size_t num_nodes;
@@ -3,6 +3,7 @@
 #include "implementation/trie.hpp"
 #include "utils/statistics_collector.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <iostream>
 #include <map>
@@ -14,7 +15,13 @@
 
 #include <boost/sort/sort.hpp>
 
-template <class PayloadType = DummyPayload, class TrieImpl = ParallelTrie<PayloadType>, bool collect_stats = false>
+// How SortedBuildupTrie passes the sorted words to the trie. SORTED and PARTITIONED deduplicate them and call
+// TrieImpl::insert_sorted / insert_partitioned (VectorizedParallelTrie), which build the trie without the
+// intermediate tries of insert.
+enum class SortedInsert { INSERT, SORTED, PARTITIONED };
+
+template <class PayloadType = DummyPayload, class TrieImpl = ParallelTrie<PayloadType>, bool collect_stats = false,
+          SortedInsert method = SortedInsert::INSERT>
 class SortedBuildupTrie {
 
   public:
@@ -24,6 +31,7 @@ class SortedBuildupTrie {
   public:
     using NodePtrType = typename TrieImpl::NodePtrType;
     using ChildPtrIteratorType = typename TrieImpl::ChildPtrIteratorType;
+    static constexpr bool counts_subtrees = CountsSubtrees<TrieImpl>;
 
     void insert(std::vector<std::string>& words) {
         if constexpr (collect_stats) {
@@ -42,10 +50,26 @@ class SortedBuildupTrie {
             statistics_collector::get().stop_measure();
         }
 
+        if constexpr (method != SortedInsert::INSERT) {
+            if constexpr (collect_stats) {
+                statistics_collector::get().start_measure("unique");
+            }
+            sorted_words.erase(std::unique(sorted_words.begin(), sorted_words.end()), sorted_words.end());
+            if constexpr (collect_stats) {
+                statistics_collector::get().stop_measure();
+            }
+        }
+
         if constexpr (collect_stats) {
             statistics_collector::get().start_measure("insert");
         }
-        trie.insert(sorted_words);
+        if constexpr (method == SortedInsert::SORTED) {
+            trie.insert_sorted(sorted_words);
+        } else if constexpr (method == SortedInsert::PARTITIONED) {
+            trie.insert_partitioned(sorted_words);
+        } else {
+            trie.insert(sorted_words);
+        }
         if constexpr (collect_stats) {
             statistics_collector::get().stop_measure();
         }
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "implementation/levenshtein_penalty_functions.hpp"
+#include "implementation/radix_trie.hpp"
+#include "implementation/trie.hpp"
+#include "implementation/vectorized_trie.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Approximate dictionary matching over long texts: finds every span of the text that matches a dictionary word within
+// max_cost. The dp aligns the trie against the text with a free start position (semi-global alignment), sub-tries
+// whose row exceeds max_cost everywhere are pruned.
+//
+// The text is cut into chunks that are scanned in parallel. Every chunk also aligns the longest span that can end
+// inside it (overlap), but only reports the spans that end inside it, so no hit is reported twice.
+template <class PenaltyClass = levenshtein::KBDistance, class ParallelTrieImpl = VectorizedParallelTrie<DummyPayload>,
+          bool collect_stats = false>
+    requires(!EdgeTrie<ParallelTrieImpl>)
+class StreamingLevenshtein {
+
+  private:
+    using NodePtrType = typename ParallelTrieImpl::NodePtrType;
+    using ChildPtrIteratorType = typename ParallelTrieImpl::ChildPtrIteratorType;
+
+  public:
+    struct Hit {
+        // position of the span in the text
+        std::size_t offset;
+        std::size_t length;
+        std::string word;
+        float cost;
+    };
+
+    StreamingLevenshtein(PenaltyClass penalty, std::size_t num_threads = std::thread::hardware_concurrency(),
+                         std::size_t chunk_size = 1 << 14)
+        : penalty(penalty), num_threads(num_threads), chunk_size(chunk_size), trie(num_threads) {}
+
+    void precompute(std::vector<std::string>& words) noexcept {
+        trie.insert(words);
+
+        max_word_size = 0;
+        for (auto& word : words) {
+            max_word_size = std::max(max_word_size, word.size());
+        }
+
+        min_remove = std::numeric_limits<float>().max();
+        for (int c = 1; c < 128; c++) {
+            min_remove = std::min(min_remove, penalty.remove(static_cast<char>(c)));
+        }
+    }
+
+    // all spans of text that match a word within max_cost, ordered by offset. Of the spans that align the same word
+    // starting at the same offset, only the cheapest is reported.
+    std::vector<Hit> scan(const std::string& text, const float max_cost) {
+        std::vector<Hit> hits;
+        scan_block(text, 0, 0, max_cost, hits);
+        return finalize(std::move(hits));
+    }
+
+    // scan() for texts that do not fit into memory, read in blocks of block_size characters
+    std::vector<Hit> scan(std::istream& in, const float max_cost, const std::size_t block_size = 1 << 24) {
+        std::vector<Hit> hits;
+        const std::size_t overlap = get_overlap(max_cost);
+
+        // the tail of the previous block is aligned again, but its spans were reported already
+        std::string buffer;
+        std::size_t buffer_offset = 0;
+        std::string block(block_size, '\0');
+
+        while (in.read(block.data(), block_size) || in.gcount() > 0) {
+            const std::size_t reported = buffer.size();
+            buffer.append(block.data(), in.gcount());
+
+            scan_block(buffer, reported, buffer_offset, max_cost, hits);
+
+            const std::size_t keep = std::min(overlap, buffer.size());
+            buffer_offset += buffer.size() - keep;
+            buffer.erase(0, buffer.size() - keep);
+        }
+
+        return finalize(std::move(hits));
+    }
+
+  private:
+    // longest span that can match a word within max_cost: every character beyond the word must be removed
+    std::size_t get_overlap(const float max_cost) const {
+        assert(min_remove > 0);
+        return max_word_size + static_cast<std::size_t>(max_cost / min_remove);
+    }
+
+    // reports the spans of text that end after position `reported`, offsets are shifted by text_offset
+    void scan_block(const std::string& text, const std::size_t reported, const std::size_t text_offset,
+                    const float max_cost, std::vector<Hit>& hits) {
+        const std::size_t overlap = get_overlap(max_cost);
+        const std::size_t num_chunks = (text.size() - std::min(reported, text.size()) + chunk_size - 1) / chunk_size;
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("scan");
+        }
+
+#pragma omp parallel num_threads(num_threads)
+        {
+            std::vector<Hit> local_hits;
+
+#pragma omp for schedule(dynamic, 1)
+            for (std::size_t c = 0; c < num_chunks; c++) {
+                // spans ending in (owned_begin, owned_end] belong to this chunk
+                const std::size_t owned_begin = reported + c * chunk_size;
+                const std::size_t owned_end = std::min(owned_begin + chunk_size, text.size());
+                const std::size_t begin = owned_begin - std::min(owned_begin, overlap);
+
+                scan_chunk(text, begin, owned_begin, owned_end, max_cost, local_hits);
+            }
+
+#pragma omp critical
+            for (Hit& hit : local_hits) {
+                hit.offset += text_offset;
+                hits.push_back(std::move(hit));
+            }
+        }
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+        }
+    }
+
+    // Depth first over the trie, with one dp row (and the start of the best alignment of every cell) per depth
+    void scan_chunk(const std::string& text, const std::size_t begin, const std::size_t owned_begin,
+                    const std::size_t owned_end, const float max_cost, std::vector<Hit>& hits) {
+        const std::size_t row_size = owned_end - begin + 1;
+
+        std::vector<float> rows((max_word_size + 1) * row_size);
+        std::vector<std::uint32_t> starts((max_word_size + 1) * row_size);
+
+        // root: a span may start anywhere
+        for (std::size_t j = 0; j < row_size; j++) {
+            rows[j] = 0.f;
+            starts[j] = j;
+        }
+
+        // node, depth
+        std::vector<std::pair<NodePtrType, std::size_t>> stack;
+        ChildPtrIteratorType it;
+        ChildPtrIteratorType end;
+        for (std::tie(it, end) = trie.get_child_iterator(trie.get_root()); it != end; it++) {
+            stack.emplace_back(trie.dereference_child_iterator(it), 1);
+        }
+
+        while (!stack.empty()) {
+            const auto [node, depth] = stack.back();
+            stack.pop_back();
+
+            const float* parent = &rows[(depth - 1) * row_size];
+            const std::uint32_t* parent_starts = &starts[(depth - 1) * row_size];
+            float* row = &rows[depth * row_size];
+            std::uint32_t* row_starts = &starts[depth * row_size];
+
+            const char character = trie.get_character(node);
+            const float insert_penalty = penalty.insert(character);
+
+            float min = row[0] = parent[0] + insert_penalty;
+            row_starts[0] = parent_starts[0];
+
+            for (std::size_t j = 1; j < row_size; j++) {
+                const char t = text[begin + j - 1];
+                const float insert = parent[j] + insert_penalty;
+                const float remove = row[j - 1] + penalty.remove(t);
+                const float modify = parent[j - 1] + penalty.modify(character, t);
+
+                if (modify <= insert && modify <= remove) {
+                    row[j] = modify;
+                    row_starts[j] = parent_starts[j - 1];
+                } else if (insert <= remove) {
+                    row[j] = insert;
+                    row_starts[j] = parent_starts[j];
+                } else {
+                    row[j] = remove;
+                    row_starts[j] = row_starts[j - 1];
+                }
+
+                min = std::min(min, row[j]);
+            }
+
+            // every word below extends this row
+            if (min > max_cost)
+                continue;
+
+            if (trie.is_leaf(node)) {
+                for (std::size_t j = owned_begin - begin + 1; j < row_size; j++) {
+                    if (row[j] <= max_cost && row_starts[j] < j) {
+                        hits.push_back(Hit{begin + row_starts[j], j - row_starts[j], trie.get_word(node), row[j]});
+                    }
+                }
+            }
+
+            for (std::tie(it, end) = trie.get_child_iterator(node); it != end; it++) {
+                stack.emplace_back(trie.dereference_child_iterator(it), depth + 1);
+            }
+        }
+    }
+
+    static std::vector<Hit> finalize(std::vector<Hit> hits) {
+        std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) {
+            return std::tie(a.offset, a.word, a.cost, a.length) < std::tie(b.offset, b.word, b.cost, b.length);
+        });
+
+        // keep the cheapest span per offset and word
+        hits.erase(std::unique(hits.begin(), hits.end(),
+                               [](const Hit& a, const Hit& b) { return a.offset == b.offset && a.word == b.word; }),
+                   hits.end());
+
+        return hits;
+    }
+
+  private:
+    const PenaltyClass penalty;
+    const std::size_t num_threads;
+    const std::size_t chunk_size;
+    ParallelTrieImpl trie;
+
+    std::size_t max_word_size = 0;
+    float min_remove = 1.f;
+};
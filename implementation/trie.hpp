@@ -1,10 +1,16 @@
 #pragma once
 
+#include "implementation/arena.hpp"
 #include "implementation/concurrent_container.hpp"
+#include "implementation/locking.hpp"
 #include "utils/statistics_collector.hpp"
 
+#include <omp.h>
+
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -125,24 +131,120 @@ inline void bfs_trie(TrieImpl& trie, typename TrieImpl::NodePtrType root,
         thread.join();
 }
 
+// The nodes of the trie level by level, in breadth first order. A level is expanded in parallel: every thread counts
+// the children of its part of the level, a prefix sum over the counts yields where each thread writes its children
+// into the next level.
+template <class TrieImpl>
+inline std::vector<std::vector<typename TrieImpl::NodePtrType>>
+trie_levels(TrieImpl& trie, typename TrieImpl::NodePtrType root,
+            std::size_t num_threads = std::thread::hardware_concurrency()) {
+    using ChildPtrIteratorType = typename TrieImpl::ChildPtrIteratorType;
+    using NodePtrType = typename TrieImpl::NodePtrType;
+
+    std::vector<std::vector<NodePtrType>> levels;
+    levels.push_back({root});
+
+    // per thread number of children, exclusive prefix sum after the first pass
+    std::vector<std::size_t> offsets(num_threads + 1);
+
+    while (true) {
+        const std::vector<NodePtrType>& level = levels.back();
+        std::vector<NodePtrType> next_level;
+
+#pragma omp parallel num_threads(num_threads)
+        {
+            const std::size_t t = omp_get_thread_num();
+            const std::size_t threads = omp_get_num_threads();
+            const std::size_t begin = level.size() * t / threads;
+            const std::size_t end = level.size() * (t + 1) / threads;
+
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType children_end;
+
+            std::size_t count = 0;
+            for (std::size_t k = begin; k < end; k++) {
+                std::tie(it, children_end) = trie.get_child_iterator(level[k]);
+                count += children_end - it;
+            }
+            offsets[t + 1] = count;
+
+#pragma omp barrier
+#pragma omp single
+            {
+                offsets[0] = 0;
+                for (std::size_t i = 1; i <= threads; i++)
+                    offsets[i] += offsets[i - 1];
+                next_level.resize(offsets[threads]);
+            }
+
+            std::size_t position = offsets[t];
+            for (std::size_t k = begin; k < end; k++) {
+                std::tie(it, children_end) = trie.get_child_iterator(level[k]);
+                for (; it != children_end; it++)
+                    next_level[position++] = trie.dereference_child_iterator(it);
+            }
+        }
+
+        if (next_level.empty())
+            break;
+        levels.push_back(std::move(next_level));
+    }
+
+    return levels;
+}
+
+// Tries that store the number of nodes below each node in payload.num_children while they are built
+template <class TrieImpl> concept CountsSubtrees = requires { requires TrieImpl::counts_subtrees; };
+
+template <class PayloadType> concept SubtreeCountPayload = requires(PayloadType payload) { payload.num_children; };
+
+// Stores the number of nodes below every node in payload.num_children, bottom up over the levels of trie_levels. A
+// node only reads its children, which are on the level below, so each level is summed up in parallel.
+template <class TrieImpl>
+inline void count_subtrees(TrieImpl& trie, std::size_t num_threads = std::thread::hardware_concurrency()) {
+    using ChildPtrIteratorType = typename TrieImpl::ChildPtrIteratorType;
+    using NodePtrType = typename TrieImpl::NodePtrType;
+
+    if constexpr (CountsSubtrees<TrieImpl>) {
+        // counted while building
+        return;
+    }
+
+    std::vector<std::vector<NodePtrType>> levels = trie_levels(trie, trie.get_root(), num_threads);
+
+    for (std::size_t depth = levels.size(); depth-- > 0;) {
+        const std::vector<NodePtrType>& level = levels[depth];
+
+#pragma omp parallel for num_threads(num_threads)
+        for (std::size_t k = 0; k < level.size(); k++) {
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType end;
+            std::tie(it, end) = trie.get_child_iterator(level[k]);
+
+            std::size_t count = 0;
+            for (; it != end; it++)
+                count += trie.get_payload(trie.dereference_child_iterator(it)).num_children + 1;
+
+            trie.get_payload(level[k]).num_children = count;
+        }
+    }
+}
+
 struct DummyPayload {};
 
 template <class PayloadType = DummyPayload, bool collect_stats = false> class ParallelTrie {
 
   public:
-    // Evaluation shows that is is better to have a separate node with vectors
+    // Node of the finished trie, copied from the TempTrieNode of the build (its brother). Only the children that
+    // exist are kept, in a packed array of num_children pointers. The nodes and these arrays live in the arenas of
+    // the trie and are freed with it, without visiting them.
     struct ParallelTrieNode {
         friend ParallelTrie;
 
         static constexpr int CHAR_SIZE = 128;
 
         ParallelTrieNode(ParallelTrieNode* parent, char character)
-            : leaf(false), parent(parent), character(character) {}
-
-        ~ParallelTrieNode() {
-            for (ParallelTrieNode* child : children)
-                delete child;
-        }
+            : leaf(false), parent(parent), character(character), children(nullptr), num_children(0) {}
 
       private:
         // can only be changed to true -> no atomic needed
@@ -152,54 +254,123 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
         const char character;
         PayloadType payload;
 
-        // compress the static array into this vector
-        std::vector<ParallelTrieNode*> children;
+        // compress the static array into this array
+        ParallelTrieNode** children;
+        std::size_t num_children;
         std::size_t index;
     };
 
   private:
+    // Node of the concurrent build. The first SMALL_SIZE children are kept in a small array, a node with more
+    // children gets a table indexed by the character that holds all of them. Lookups are lock free, a missing child
+    // is added under the lock of the node after a second lookup, so no node is allocated in vain.
     struct TempTrieNode {
         friend ParallelTrie;
 
         static constexpr int CHAR_SIZE = 128;
+        static constexpr int SMALL_SIZE = 4;
+
+        TempTrieNode(TempTrieNode* parent, char character)
+            : leaf(false), character(character), lock(false), small_size(0), parent(parent), table(nullptr) {}
+
+        TempTrieNode* find(const char c) const {
+            std::atomic<TempTrieNode*>* children = table.load(std::memory_order_acquire);
+            if (children != nullptr)
+                return children[static_cast<int>(c)].load(std::memory_order_acquire);
+
+            const int size = small_size.load(std::memory_order_acquire);
+            for (int i = 0; i < size; i++) {
+                if (small_characters[i] == c)
+                    return small_children[i];
+            }
+            return nullptr;
+        }
 
-        TempTrieNode(TempTrieNode* parent, char character) : leaf(false), parent(parent), character(character) {
+        // called after find(c) failed, returns the child of c and sets added unless another thread added it meanwhile
+        TempTrieNode* add(const char c, Arena& arena, bool& added) {
+            added = false;
+
+            lock_atomic(lock);
+            TempTrieNode* child = find(c);
+            if (child == nullptr) {
+                child = arena.make<TempTrieNode>(this, c);
+                added = true;
+
+                const int size = small_size.load(std::memory_order_relaxed);
+                if (size < SMALL_SIZE) {
+                    small_characters[size] = c;
+                    small_children[size] = child;
+                    small_size.store(size + 1, std::memory_order_release);
+                } else {
+                    std::atomic<TempTrieNode*>* children = table.load(std::memory_order_relaxed);
+                    if (children == nullptr) {
+                        children = arena.make_array<std::atomic<TempTrieNode*>>(CHAR_SIZE);
+                        for (int i = 0; i < SMALL_SIZE; i++)
+                            children[static_cast<int>(small_characters[i])].store(small_children[i],
+                                                                                  std::memory_order_relaxed);
+                        table.store(children, std::memory_order_release);
+                    }
+                    children[static_cast<int>(c)].store(child, std::memory_order_release);
+                }
+            }
+            unlock_atomic(lock);
 
-            for (int i = 0; i < CHAR_SIZE; i++)
-                children[i].store(nullptr, std::memory_order_relaxed);
+            return child;
         }
 
-        ~TempTrieNode() {
-            for (int i = 0; i < CHAR_SIZE; i++)
-                if (children[i].load(std::memory_order_relaxed) != nullptr)
-                    delete children[i].load();
+        // calls f for the children in the order of their characters, must not run concurrently to add
+        template <class Function> void for_each_child(const Function& f) const {
+            std::atomic<TempTrieNode*>* children = table.load(std::memory_order_acquire);
+            if (children != nullptr) {
+                for (int i = 0; i < CHAR_SIZE; i++) {
+                    TempTrieNode* child = children[i].load(std::memory_order_relaxed);
+                    if (child != nullptr)
+                        f(child);
+                }
+                return;
+            }
+
+            // insertion sort of the few children of the small array
+            const int size = small_size.load(std::memory_order_acquire);
+            TempTrieNode* sorted[SMALL_SIZE];
+            for (int i = 0; i < size; i++) {
+                int j = i;
+                for (; j > 0 && sorted[j - 1]->character > small_children[i]->character; j--)
+                    sorted[j] = sorted[j - 1];
+                sorted[j] = small_children[i];
+            }
+            for (int i = 0; i < size; i++)
+                f(sorted[i]);
         }
 
       private:
         // can only be changed to true -> no atomic needed
         bool leaf;
+        const char character;
+        // held while a child is added
+        std::atomic<bool> lock;
+        std::atomic<std::uint8_t> small_size;
+        char small_characters[SMALL_SIZE];
         // must be 0 for root
         TempTrieNode* const parent;
         ParallelTrieNode* brother;
-        const char character;
-        // may be deleted, and set to nullptr
-        std::atomic<TempTrieNode*> children[CHAR_SIZE];
+        TempTrieNode* small_children[SMALL_SIZE];
+        // all children, once there are more than SMALL_SIZE
+        std::atomic<std::atomic<TempTrieNode*>*> table;
     };
 
     using NodeType = ParallelTrieNode;
 
   public:
     using NodePtrType = NodeType*;
-    using ChildPtrIteratorType = typename std::vector<ParallelTrieNode*>::const_iterator;
+    using ChildPtrIteratorType = ParallelTrieNode* const*;
     NodePtrType null = nullptr;
 
   public:
+    // one arena per thread of the compression, the root is in the first one
     ParallelTrie(std::size_t num_threads = std::thread::hardware_concurrency())
-        : root(new ParallelTrieNode(nullptr, '\0')), num_threads(num_threads), num_nodes(1) {}
-
-    ~ParallelTrie() {
-        delete root;
-    }
+        : arenas(std::max<std::size_t>(num_threads, 1)), root(arenas[0].make<ParallelTrieNode>(nullptr, '\0')),
+          num_threads(num_threads), num_nodes(1) {}
 
     void insert(std::vector<std::string>& words) {
 
@@ -208,13 +379,16 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
         }
 
         // BUILD TRIE -----------------------------
-        TempTrieNode* temp_root = new TempTrieNode(nullptr, '\0');
+        // one arena per thread, the temporary trie is released as a whole after the compression
+        std::vector<Arena> temp_arenas(num_threads);
+        TempTrieNode* temp_root = temp_arenas[0].make<TempTrieNode>(nullptr, '\0');
         std::size_t collisions = 0;
 
 #pragma omp parallel num_threads(num_threads), shared(num_nodes, collisions)
         {
             std::size_t local_nodes = 0;
             std::size_t local_collisions = 0;
+            Arena& arena = temp_arenas[omp_get_thread_num()];
 
 #pragma omp for
             for (std::size_t i = 0; i < words.size(); i++) {
@@ -228,24 +402,19 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
                     // fit in our datatype
                     assert(word[j] < TempTrieNode::CHAR_SIZE && word[j] > 0);
 
-                    std::atomic<TempTrieNode*>& child = current->children[static_cast<int>(word[j])];
-
-                    TempTrieNode* child_ptr = child.load(std::memory_order_relaxed);
+                    TempTrieNode* child = current->find(word[j]);
 
-                    if (child_ptr == nullptr) {
-                        TempTrieNode* new_child_ptr = new TempTrieNode(current, word[j]);
-                        if (child.compare_exchange_strong(child_ptr, new_child_ptr, std::memory_order_relaxed)) {
-                            current = new_child_ptr;
+                    if (child == nullptr) {
+                        bool added;
+                        child = current->add(word[j], arena, added);
+                        if (added) {
                             local_nodes++;
-                        } else {
-                            delete new_child_ptr;
-                            current = child_ptr;
-                            if constexpr (collect_stats)
-                                local_collisions++;
+                        } else if constexpr (collect_stats) {
+                            local_collisions++;
                         }
-                    } else {
-                        current = child_ptr;
                     }
+
+                    current = child;
                 }
 
                 current->leaf = true;
@@ -271,22 +440,9 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
         std::mutex global_task_queue_mtx;
         std::queue<TempTrieNode*> task_queue;
 
-        ChildPtrIteratorType begin;
-        ChildPtrIteratorType end;
-        // COPY NODE
+        // COPY NODE AND ADD CHILDREN
         temp_root->brother = root;
-        temp_root->brother->leaf = temp_root->leaf;
-
-        // ADD CHILDREN
-        for (int i = 0; i < ParallelTrieNode::CHAR_SIZE; i++) {
-            TempTrieNode* child = temp_root->children[i].load(std::memory_order_relaxed);
-            if (child != nullptr) {
-                ParallelTrieNode* new_child = new ParallelTrieNode(temp_root->brother, child->character);
-                child->brother = new_child;
-                temp_root->brother->children.push_back(new_child);
-                task_queue.push(child);
-            }
-        }
+        copy_node(temp_root, arenas[0], [&](TempTrieNode* child) { task_queue.push(child); });
 
         std::vector<std::thread> threads;
 
@@ -307,8 +463,6 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
                 // Work from Queue until all nodes are processed
                 TempTrieNode* current;
                 std::size_t local_done = 0;
-                ChildPtrIteratorType it;
-                ChildPtrIteratorType end;
 
                 while (true) {
                     global_task_queue_mtx.lock();
@@ -324,20 +478,8 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
                             current = local_task_queue.front();
                             local_task_queue.pop();
 
-                            // COPY NODE
-                            current->brother->leaf = current->leaf;
-
-                            // ADD CHILDREN
-                            for (int i = 0; i < ParallelTrieNode::CHAR_SIZE; i++) {
-                                TempTrieNode* child = current->children[i].load(std::memory_order_relaxed);
-                                if (child != nullptr) {
-                                    ParallelTrieNode* new_child =
-                                        new ParallelTrieNode(current->brother, child->character);
-                                    child->brother = new_child;
-                                    current->brother->children.push_back(new_child);
-                                    local_task_queue.push(child);
-                                }
-                            }
+                            // COPY NODE AND ADD CHILDREN
+                            copy_node(current, arenas[t], [&](TempTrieNode* child) { local_task_queue.push(child); });
 
                             local_done++;
 
@@ -382,7 +524,13 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
         for (auto& thread : threads)
             thread.join();
 
-        delete temp_root;
+        if constexpr (collect_stats) {
+            std::size_t temp_bytes = 0;
+            for (const Arena& arena : temp_arenas)
+                temp_bytes += arena.get_reserved();
+            statistics_collector::get().add_stat("temp_bytes", std::to_string(temp_bytes));
+        }
+        temp_arenas.clear();
 
         if constexpr (collect_stats) {
             statistics_collector::get().stop_measure();
@@ -390,18 +538,14 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
         }
 
         // SET INDICES -----------------------------
-
-        std::queue<NodePtrType> q;
-        q.push(root);
+        // breadth first, a level starts after the nodes of the previous levels
 
         std::size_t index_ctr = 0;
-        while (!q.empty()) {
-            NodePtrType current = q.front();
-            q.pop();
-
-            current->index = index_ctr++;
-            for (auto child : current->children)
-                q.push(child);
+        for (const std::vector<NodePtrType>& level : trie_levels(*this, root, num_threads)) {
+#pragma omp parallel for num_threads(num_threads)
+            for (std::size_t k = 0; k < level.size(); k++)
+                level[k]->index = index_ctr + k;
+            index_ctr += level.size();
         }
 
         if constexpr (collect_stats) {
@@ -439,7 +583,7 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
     }
 
     std::pair<ChildPtrIteratorType, ChildPtrIteratorType> get_child_iterator(NodePtrType node_ptr) {
-        return {node_ptr->children.begin(), node_ptr->children.end()};
+        return {node_ptr->children, node_ptr->children + node_ptr->num_children};
     }
 
     NodePtrType dereference_child_iterator(ChildPtrIteratorType it) {
@@ -460,6 +604,30 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Pa
     }
 
   private:
+    // copies the leaf flag of current to its brother and creates the brothers of its children in arena
+    template <class Push> static void copy_node(TempTrieNode* current, Arena& arena, const Push& push) {
+        ParallelTrieNode* node = current->brother;
+        node->leaf = current->leaf;
+
+        TempTrieNode* children[TempTrieNode::CHAR_SIZE];
+        std::size_t count = 0;
+        current->for_each_child([&](TempTrieNode* child) { children[count++] = child; });
+
+        if (count == 0)
+            return;
+
+        node->children = arena.make_array<ParallelTrieNode*>(count);
+        node->num_children = count;
+        for (std::size_t i = 0; i < count; i++) {
+            ParallelTrieNode* new_child = arena.make<ParallelTrieNode>(node, children[i]->character);
+            children[i]->brother = new_child;
+            node->children[i] = new_child;
+            push(children[i]);
+        }
+    }
+
+  private:
+    std::vector<Arena> arenas;
     NodePtrType root;
     std::size_t num_threads;
     std::size_t num_nodes;
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "implementation/cpu_dispatch.hpp"
+#include "implementation/locking.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+template <class TrieImpl> inline bool has_children(TrieImpl& trie, typename TrieImpl::NodePtrType node) {
+    auto iters = trie.get_child_iterator(node);
+    return iters.first != iters.second;
+}
+
+// Parallel top-n search over a trie, shared by the query modes of the dp engines.
+//
+// calculate_children(node) is called once for every explored node (starting with the root) and must set the payload
+// of all children of node: distance is the score of the child if it is a leaf, min_distance a lower bound for the
+// scores of all leaves in the subtree of the child. With early break, sub-trees whose bound cannot beat the current
+// n-th best are skipped, which additionally requires num_children (number of nodes below a node) in the payload.
+//
+// calculate_children runs in the instruction set variant selected by cpu_dispatch. If it also takes a float, it gets
+// the bound a child must not exceed to be explored and may stop computing children beyond it early, as long as their
+// min_distance stays above the bound.
+//
+// Once *cancelled is set, the threads stop taking nodes and the search returns the leaves found so far.
+//
+// Returns the best n leaves as (score, node), ordered by score.
+template <class TrieImpl, bool early_break, bool collect_stats, class CalculateChildren>
+std::vector<std::pair<float, typename TrieImpl::NodePtrType>>
+search_trie(TrieImpl& trie, const std::size_t n, const std::size_t num_threads,
+            const CalculateChildren& calculate_children, const std::atomic<bool>* cancelled = nullptr) {
+    using NodePtrType = typename TrieImpl::NodePtrType;
+    using ChildPtrIteratorType = typename TrieImpl::ChildPtrIteratorType;
+
+    // Prepare
+
+    if constexpr (collect_stats) {
+        statistics_collector::get().add_stat("num_nodes", std::to_string(trie.get_num_nodes()));
+        statistics_collector::get().add_stat("isa", cpu_dispatch::to_string(cpu_dispatch::selected()));
+    }
+    std::size_t skipped_nodes = 0;
+
+    std::queue<NodePtrType> task_queue;
+    std::mutex global_task_queue_mtx;
+
+    // the smallest of all largest elements in queues
+    alignas(CACHE_LINE_SIZE) std::atomic<float> early_break_min_max;
+    early_break_min_max.store(std::numeric_limits<float>().max(), std::memory_order_relaxed);
+
+    const auto calculate = [&](const NodePtrType& node, const float bound) {
+        if constexpr (std::is_invocable_v<const CalculateChildren&, NodePtrType, float>) {
+            cpu_dispatch::dispatch([&]() { calculate_children(node, bound); });
+        } else {
+            cpu_dispatch::dispatch([&]() { calculate_children(node); });
+        }
+    };
+
+    calculate(trie.get_root(), std::numeric_limits<float>().max());
+
+    // the threads only collect leaves below the nodes they process, words of a single character are collected here
+    std::mutex global_queue_mtx;
+    std::priority_queue<std::pair<float, NodePtrType>> q;
+
+    ChildPtrIteratorType begin;
+    ChildPtrIteratorType end;
+    std::tie(begin, end) = trie.get_child_iterator(trie.get_root());
+    for (ChildPtrIteratorType it = begin; it != end; it++) {
+        NodePtrType child = trie.dereference_child_iterator(it);
+        task_queue.push(child);
+
+        if (n > 0 && trie.is_leaf(child) && (q.size() < n || trie.get_payload(child).distance < q.top().first)) {
+            q.emplace(trie.get_payload(child).distance, child);
+            if (q.size() > n)
+                q.pop();
+        }
+    }
+
+    // Parallel execution
+    std::vector<std::thread> threads;
+    struct alignas(CACHE_LINE_SIZE / 2) Signal {
+        Signal() : other_needes_work(false) {}
+        std::atomic<bool> other_needes_work;
+    };
+    Signal signals[num_threads];
+    std::atomic<std::size_t> global_missing(trie.get_num_nodes() - 1);
+
+    for (unsigned int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            std::priority_queue<std::pair<float, NodePtrType>> local_q;
+            std::queue<NodePtrType> local_task_queue;
+
+            // Work from Queue until all nodes are processed
+            NodePtrType current;
+            std::size_t local_done = 0;
+            ChildPtrIteratorType it;
+            ChildPtrIteratorType end;
+            float global_min_max = early_break_min_max.load(std::memory_order_relaxed);
+            std::size_t local_skipped = 0;
+
+            while (true) {
+                if (cancelled && cancelled->load(std::memory_order_relaxed))
+                    break;
+
+                global_task_queue_mtx.lock();
+                if (!task_queue.empty()) {
+
+                    local_task_queue.push(task_queue.front());
+                    task_queue.pop();
+
+                    global_task_queue_mtx.unlock();
+
+                    // got work
+                    do {
+                        if (cancelled && cancelled->load(std::memory_order_relaxed))
+                            break;
+
+                        current = local_task_queue.front();
+                        local_task_queue.pop();
+
+                        float bound = std::numeric_limits<float>().max();
+                        if constexpr (early_break) {
+                            if (!local_q.empty() && local_q.size() >= n)
+                                bound = std::min(global_min_max, local_q.top().first);
+                        }
+
+                        calculate(current, bound);
+                        local_done++;
+
+                        // Fill Task-Queue and update current
+                        std::tie(it, end) = trie.get_child_iterator(current);
+
+                        // Check the local minimum only once for all
+                        // children
+                        if constexpr (early_break) {
+                            if (local_q.size() >= n) {
+                                global_min_max = early_break_min_max.load(std::memory_order_relaxed);
+
+                                if (local_q.top().first < global_min_max) {
+                                    early_break_min_max.store(local_q.top().first, std::memory_order_relaxed);
+                                    global_min_max = local_q.top().first;
+                                }
+                            }
+                        }
+
+                        // Add children to work and result queue
+                        for (; it != end; it++) {
+                            NodePtrType child = trie.dereference_child_iterator(it);
+
+                            // Work -> Local Queue
+                            if (trie.is_leaf(child)) {
+                                if (local_q.size() < n ||
+                                    trie.get_payload(child).distance < local_q.top().first) { // order matters here
+                                    local_q.emplace(trie.get_payload(child).distance, child);
+                                    if (local_q.size() > n)
+                                        local_q.pop();
+                                }
+                            }
+
+                            // Test if we should check out children of
+                            // children
+                            if constexpr (early_break) {
+                                // Do not explore if it can only get worse
+                                if (local_q.size() >= n) {
+                                    if (trie.get_payload(child).min_distance >
+                                        std::min(global_min_max, local_q.top().first)) {
+                                        local_done += trie.get_payload(child).num_children + 1;
+
+                                        if constexpr (collect_stats) {
+                                            local_skipped += trie.get_payload(child).num_children + 1;
+                                        }
+
+                                    } else if (has_children(trie, child)) {
+                                        // We keep one child locally
+                                        local_task_queue.push(child);
+                                    } else {
+                                        // does not have children, skip
+                                        // queuing
+                                        local_done++;
+                                    }
+                                } else {
+                                    local_task_queue.push(child);
+                                }
+                            } else {
+                                local_task_queue.push(child);
+                            }
+                        }
+
+                        const std::size_t size = local_task_queue.size();
+                        if (size > 1000 && signals[t].other_needes_work.load(std::memory_order_relaxed)) {
+                            global_task_queue_mtx.lock();
+
+                            for (std::size_t i = 0; i < size / 2; i++) {
+                                task_queue.push(local_task_queue.front());
+                                local_task_queue.pop();
+                            }
+
+                            // std::cout << task_queue.size() << std::endl;
+                            global_task_queue_mtx.unlock();
+                            signals[t].other_needes_work.store(false, std::memory_order_relaxed);
+                        }
+                    } while (!local_task_queue.empty());
+
+                } else { // global queue is empty
+                    global_task_queue_mtx.unlock();
+                    // update done counter and check if thread should stop
+                    if (local_done) {
+                        std::size_t missing =
+                            global_missing.fetch_sub(local_done, std::memory_order_relaxed) - local_done;
+
+                        if (missing <= 0) {
+                            break;
+                        }
+                        local_done = 0;
+                    } else if (global_missing.load(std::memory_order_relaxed) <= 0) {
+                        break;
+                    }
+
+                    signals[(t + 1) % num_threads].other_needes_work.store(true, std::memory_order_relaxed);
+                }
+            }
+
+            // Local Queue -> Global Queue
+            global_queue_mtx.lock();
+            while (!local_q.empty()) {
+                std::pair<float, NodePtrType> entry = std::move(local_q.top());
+                local_q.pop();
+
+                if (q.size() < n || entry.first < q.top().first) { // order matters here
+                    q.push(entry);
+                    if (q.size() > n)
+                        q.pop();
+                }
+            }
+            skipped_nodes += local_skipped;
+            global_queue_mtx.unlock();
+            //-------------------------------
+        });
+    }
+
+    // Wait for threads to finish execution
+    for (auto& thread : threads)
+        thread.join();
+
+    // Queue -> Result vector
+    std::vector<std::pair<float, NodePtrType>> result(q.size());
+    while (!q.empty()) {
+        result[q.size() - 1] = q.top();
+        q.pop();
+    }
+
+    if constexpr (collect_stats) {
+        statistics_collector::get().add_stat("skipped_nodes", std::to_string(skipped_nodes));
+    }
+
+    return result;
+}
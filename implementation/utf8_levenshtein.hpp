@@ -0,0 +1,63 @@
+#pragma once
+
+#include "implementation/alphabet.hpp"
+#include "implementation/levenshtein_penalty_functions.hpp"
+#include "utils/statistics_collector.hpp"
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Runs LevenshteinImpl, which takes a levenshtein::DensePenalty<PenaltyClass>, on UTF-8 words. precompute scans the
+// words for their Alphabet and passes the encoded words to the engine, which is only constructed then, as its
+// penalty depends on the alphabet. Queries are encoded and the words of the results decoded again. precompute throws
+// std::length_error if the words have more code points than an Alphabet holds.
+//
+// Example: Utf8Levenshtein<levenshtein::KBDistance,
+//                          AcceleratedLevenshtein<levenshtein::DensePenalty<levenshtein::KBDistance>>>
+template <class PenaltyClass, class LevenshteinImpl, bool collect_stats = false> class Utf8Levenshtein {
+
+  public:
+    Utf8Levenshtein(PenaltyClass penalty, std::size_t num_threads = std::thread::hardware_concurrency())
+        : penalty(std::move(penalty)), num_threads(num_threads) {}
+
+    void precompute(std::vector<std::string>& words) {
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("alphabet");
+        }
+
+        alphabet = Alphabet(words);
+
+        std::vector<std::string> symbols(words.size());
+#pragma omp parallel for num_threads(num_threads)
+        for (std::size_t i = 0; i < words.size(); i++)
+            symbols[i] = alphabet.encode(words[i]);
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+            statistics_collector::get().add_stat("alphabet_size", std::to_string(alphabet.size()));
+        }
+
+        engine.emplace(levenshtein::DensePenalty<PenaltyClass>(penalty, alphabet), num_threads);
+        engine->precompute(symbols);
+    }
+
+    std::vector<std::pair<float, std::string>> query(const std::string& query, const std::size_t n) noexcept {
+        std::vector<std::pair<float, std::string>> result = engine->query(alphabet.encode(query), n);
+        for (auto& entry : result)
+            entry.second = alphabet.decode(entry.second);
+        return result;
+    }
+
+    const Alphabet& get_alphabet() const {
+        return alphabet;
+    }
+
+  private:
+    PenaltyClass penalty;
+    std::size_t num_threads;
+    Alphabet alphabet;
+    std::optional<LevenshteinImpl> engine;
+};
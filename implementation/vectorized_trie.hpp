@@ -4,18 +4,39 @@
 #include "implementation/trie.hpp"
 #include "utils/statistics_collector.hpp"
 
+#include <omp.h>
+
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <queue>
+#include <span>
 #include <stack>
 #include <string>
 #include <thread>
 #include <vector>
 
-template <class PayloadType = DummyPayload, bool collect_stats = false> class VectorizedParallelTrie {
+// Numbering of the nodes of VectorizedParallelTrie. The children of a node always have consecutive indices, the
+// orders differ in where the groups of siblings are placed.
+enum class NodeOrder {
+    // level by level, as numbered by ParallelTrie
+    BFS,
+    // preorder over the groups of siblings, a subtree occupies a contiguous range
+    DFS,
+    // the trie is cut into blocks of NODE_ORDER_BLOCK_HEIGHT levels (van Emde Boas layout with a single level of
+    // recursion), each block is numbered breadth first and the blocks are placed in preorder
+    BLOCKED
+};
+
+constexpr std::size_t NODE_ORDER_BLOCK_HEIGHT = 4;
+
+template <class PayloadType = DummyPayload, bool collect_stats = false, NodeOrder order = NodeOrder::BFS>
+class VectorizedParallelTrie {
 
   public:
     struct VectorizedParallelTrieNode {
@@ -41,6 +62,8 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Ve
     using NodePtrType = std::size_t;
     using ChildPtrIteratorType = std::size_t;
     static const NodePtrType null = 0;
+    // payloads with num_children get the sizes of the subtrees while the trie is built (count_subtrees)
+    static constexpr bool counts_subtrees = SubtreeCountPayload<PayloadType>;
 
   public:
     VectorizedParallelTrie(std::size_t num_threads = std::thread::hardware_concurrency())
@@ -91,6 +114,173 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Ve
         if constexpr (collect_stats) {
             statistics_collector::get().stop_measure();
         }
+
+        if constexpr (counts_subtrees) {
+            if constexpr (collect_stats) {
+                statistics_collector::get().start_measure("count_subtrees");
+            }
+            count_subtrees_by_level(nodes, num_threads);
+            if constexpr (collect_stats) {
+                statistics_collector::get().stop_measure();
+            }
+        }
+
+        if constexpr (order != NodeOrder::BFS) {
+            if constexpr (collect_stats) {
+                statistics_collector::get().start_measure("reorder");
+            }
+            reorder();
+            if constexpr (collect_stats) {
+                statistics_collector::get().stop_measure();
+            }
+        }
+    }
+
+    // Builds the trie from sorted and deduplicated words without a helper trie. The node at depth d of word i is new
+    // if it is not on the path of word i - 1, i.e. lcp(i - 1, i) < d. The trie is built level by level: the new nodes
+    // of a level are numbered by a prefix sum over the words that are long enough, in the order of the words, which
+    // is the breadth first numbering of insert. Apart from the nodes only a few words per input word are allocated.
+    void insert_sorted(const std::vector<std::string>& words) {
+        assert(std::adjacent_find(words.begin(), words.end(), std::greater_equal<std::string>()) == words.end());
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("lcp");
+        }
+
+        std::vector<std::uint32_t> lcp(words.size());
+        num_nodes = compute_lcp(words, lcp, num_threads);
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+            statistics_collector::get().start_measure("levels");
+        }
+
+        nodes.resize(num_nodes);
+        build_levels(words, lcp, nodes, num_threads);
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+        }
+
+        if constexpr (counts_subtrees) {
+            if constexpr (collect_stats) {
+                statistics_collector::get().start_measure("count_subtrees");
+            }
+            count_subtrees_by_level(nodes, num_threads);
+            if constexpr (collect_stats) {
+                statistics_collector::get().stop_measure();
+            }
+        }
+
+        if constexpr (order != NodeOrder::BFS) {
+            if constexpr (collect_stats) {
+                statistics_collector::get().start_measure("reorder");
+            }
+            reorder();
+            if constexpr (collect_stats) {
+                statistics_collector::get().stop_measure();
+            }
+        }
+    }
+
+    // Like insert_sorted, but the words are split by their first character and the sub-trie of each character is
+    // built by a single thread with the sequential level builder, so the threads share no nodes. The sub-tries are
+    // stitched under the root: the root children come first, followed by the remaining nodes of each sub-trie at an
+    // offset known from the lcp pass. The numbering is breadth first within each sub-trie.
+    void insert_partitioned(const std::vector<std::string>& words) {
+        assert(std::adjacent_find(words.begin(), words.end(), std::greater_equal<std::string>()) == words.end());
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().start_measure("lcp");
+        }
+
+        std::vector<std::uint32_t> lcp(words.size());
+        compute_lcp(words, lcp, num_threads);
+
+        // partition b: words[partitions[b], partitions[b + 1]), the empty word is not part of a partition
+        std::vector<std::size_t> partitions;
+        for (std::size_t i = 0; i < words.size(); i++) {
+            if (!words[i].empty() && lcp[i] == 0)
+                partitions.push_back(i);
+        }
+        const std::size_t num_partitions = partitions.size();
+        partitions.push_back(words.size());
+
+        // nodes of the sub-trie below the root child of b, offsets[b] the index of its first one
+        std::vector<std::size_t> offsets(num_partitions + 1, 0);
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+        for (std::size_t b = 0; b < num_partitions; b++) {
+            std::size_t count = 0;
+            for (std::size_t i = partitions[b]; i < partitions[b + 1]; i++)
+                count += words[i].size() - lcp[i];
+            offsets[b + 1] = count - 1;
+        }
+
+        offsets[0] = 1 + num_partitions;
+        for (std::size_t b = 1; b <= num_partitions; b++)
+            offsets[b] += offsets[b - 1];
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+            statistics_collector::get().add_stat("partitions", std::to_string(num_partitions));
+            statistics_collector::get().start_measure("partitions");
+        }
+
+        num_nodes = offsets[num_partitions];
+        nodes.resize(num_nodes);
+
+        nodes[0].leaf = !words.empty() && words[0].empty();
+        nodes[0].parent = 0;
+        nodes[0].character = '\0';
+        nodes[0].children_begin_index = num_partitions ? 1 : 0;
+        nodes[0].children_end_index = num_partitions ? 1 + num_partitions : 0;
+
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+        for (std::size_t b = 0; b < num_partitions; b++) {
+            const std::span<const std::string> partition_words(&words[partitions[b]],
+                                                               partitions[b + 1] - partitions[b]);
+            const std::span<const std::uint32_t> partition_lcp(&lcp[partitions[b]], partition_words.size());
+
+            // local 0: root of the sub-trie, 1: the root child of the partition, then the remaining nodes
+            std::vector<NodeType> local(offsets[b + 1] - offsets[b] + 2);
+            build_levels(partition_words, partition_lcp, local, 1);
+            if constexpr (counts_subtrees)
+                count_subtrees_by_level(local, 1);
+
+            auto global_index = [&](const std::size_t index) {
+                return index == 0 ? 0 : (index == 1 ? 1 + b : offsets[b] + index - 2);
+            };
+
+            for (std::size_t index = 1; index < local.size(); index++) {
+                const NodeType& source = local[index];
+                NodeType& node = nodes[global_index(index)];
+                node = source;
+                node.parent = global_index(source.parent);
+                if (source.children_begin_index != source.children_end_index) {
+                    node.children_begin_index = global_index(source.children_begin_index);
+                    node.children_end_index =
+                        node.children_begin_index + (source.children_end_index - source.children_begin_index);
+                }
+            }
+        }
+
+        if constexpr (counts_subtrees) {
+            nodes[0].payload.num_children = num_nodes - 1;
+        }
+
+        if constexpr (collect_stats) {
+            statistics_collector::get().stop_measure();
+        }
+
+        if constexpr (order != NodeOrder::BFS) {
+            if constexpr (collect_stats) {
+                statistics_collector::get().start_measure("reorder");
+            }
+            reorder();
+            if constexpr (collect_stats) {
+                statistics_collector::get().stop_measure();
+            }
+        }
     }
 
     NodePtrType get_root() {
@@ -142,6 +332,203 @@ template <class PayloadType = DummyPayload, bool collect_stats = false> class Ve
         return result;
     }
 
+  private:
+    // lcp[i]: length of the common prefix of words i - 1 and i (0 for the first word), returns the number of nodes
+    static std::size_t compute_lcp(std::span<const std::string> words, std::vector<std::uint32_t>& lcp,
+                                   const std::size_t num_threads) {
+        std::size_t total_nodes = 1;
+
+#pragma omp parallel for num_threads(num_threads) reduction(+ : total_nodes)
+        for (std::size_t i = 0; i < words.size(); i++) {
+            std::size_t length = 0;
+            if (i > 0) {
+                const std::string& previous = words[i - 1];
+                const std::string& word = words[i];
+                while (length < previous.size() && length < word.size() && previous[length] == word[length])
+                    length++;
+            }
+            lcp[i] = static_cast<std::uint32_t>(length);
+            total_nodes += words[i].size() - length;
+        }
+
+        return total_nodes;
+    }
+
+    // level builder of insert_sorted, nodes must have the size returned by compute_lcp
+    static void build_levels(std::span<const std::string> words, std::span<const std::uint32_t> lcp,
+                             std::vector<NodeType>& nodes, const std::size_t num_threads) {
+        const std::size_t num_words = words.size();
+
+        nodes[0].leaf = !words.empty() && words[0].empty();
+        nodes[0].parent = 0;
+        nodes[0].character = '\0';
+        nodes[0].children_begin_index = 0;
+        nodes[0].children_end_index = 0;
+
+        // words that reach the current level and the index of their node on the previous level
+        std::vector<std::size_t> active;
+        active.reserve(num_words);
+        for (std::size_t i = 0; i < num_words; i++) {
+            if (!words[i].empty())
+                active.push_back(i);
+        }
+        std::vector<std::size_t> node_of(num_words, 0);
+
+        // per thread number of new nodes, exclusive prefix sum after the first pass
+        std::vector<std::size_t> offsets(num_threads + 1);
+
+        std::size_t level_begin = 1;
+        for (std::size_t depth = 1; !active.empty(); depth++) {
+            std::size_t level_end = level_begin;
+
+#pragma omp parallel num_threads(num_threads)
+            {
+                const std::size_t t = omp_get_thread_num();
+                const std::size_t threads = omp_get_num_threads();
+                const std::size_t begin = active.size() * t / threads;
+                const std::size_t end = active.size() * (t + 1) / threads;
+
+                std::size_t local_new = 0;
+                for (std::size_t k = begin; k < end; k++)
+                    local_new += lcp[active[k]] < depth;
+                offsets[t + 1] = local_new;
+
+#pragma omp barrier
+#pragma omp single
+                {
+                    offsets[0] = level_begin;
+                    for (std::size_t i = 1; i <= threads; i++)
+                        offsets[i] += offsets[i - 1];
+                    level_end = offsets[threads];
+                }
+
+                // the node of a word is the last new node up to the word
+                std::size_t next_index = offsets[t];
+                for (std::size_t k = begin; k < end; k++) {
+                    const std::size_t i = active[k];
+                    if (lcp[i] < depth) {
+                        NodeType& node = nodes[next_index];
+                        node.leaf = words[i].size() == depth;
+                        node.parent = node_of[i];
+                        node.character = words[i][depth - 1];
+                        node.children_begin_index = 0;
+                        node.children_end_index = 0;
+                        next_index++;
+                    }
+                    node_of[i] = next_index - 1;
+                }
+
+#pragma omp barrier
+
+                // children of a parent are consecutive, the first and the last one set its range
+#pragma omp for
+                for (std::size_t index = level_begin; index < level_end; index++) {
+                    const std::size_t parent = nodes[index].parent;
+                    if (index == level_begin || nodes[index - 1].parent != parent)
+                        nodes[parent].children_begin_index = index;
+                    if (index + 1 == level_end || nodes[index + 1].parent != parent)
+                        nodes[parent].children_end_index = index + 1;
+                }
+            }
+
+            std::erase_if(active, [&](const std::size_t i) { return words[i].size() == depth; });
+            level_begin = level_end;
+        }
+
+    }
+
+    // Number of nodes below each node into payload.num_children, the nodes must be numbered breadth first. The next
+    // level ends at the largest end of the children of the current one, the levels are summed up bottom up.
+    static void count_subtrees_by_level(std::vector<NodeType>& nodes, const std::size_t num_threads) {
+        std::vector<std::pair<std::size_t, std::size_t>> levels = {{0, 1}};
+        while (true) {
+            const auto [begin, end] = levels.back();
+
+            std::size_t next_end = end;
+#pragma omp parallel for num_threads(num_threads) reduction(max : next_end)
+            for (std::size_t index = begin; index < end; index++)
+                next_end = std::max(next_end, nodes[index].children_end_index);
+
+            if (next_end == end)
+                break;
+            levels.emplace_back(end, next_end);
+        }
+
+        for (std::size_t depth = levels.size(); depth-- > 0;) {
+            const auto [begin, end] = levels[depth];
+
+#pragma omp parallel for num_threads(num_threads)
+            for (std::size_t index = begin; index < end; index++) {
+                std::size_t count = 0;
+                for (std::size_t child = nodes[index].children_begin_index; child < nodes[index].children_end_index;
+                     child++)
+                    count += nodes[child].payload.num_children + 1;
+                nodes[index].payload.num_children = count;
+            }
+        }
+    }
+
+    // moves the nodes from the breadth first numbering of the helper to order
+    void reorder() {
+        std::vector<std::size_t> new_index(num_nodes);
+        new_index[0] = 0;
+        std::size_t next_index = 1;
+
+        // numbers the children of node consecutively
+        auto number_children = [&](std::size_t node) {
+            for (std::size_t child = nodes[node].children_begin_index; child < nodes[node].children_end_index;
+                 child++) {
+                new_index[child] = next_index++;
+            }
+        };
+
+        // nodes whose children are numbered, but not their grandchildren
+        std::stack<std::size_t> stack;
+        stack.push(0);
+
+        while (!stack.empty()) {
+            std::size_t node = stack.top();
+            stack.pop();
+
+            if constexpr (order == NodeOrder::DFS) {
+                number_children(node);
+
+                for (std::size_t child = nodes[node].children_end_index; child-- > nodes[node].children_begin_index;)
+                    stack.push(child);
+            } else {
+                // the children of node start a block, number it breadth first and continue with its lowest level
+                std::vector<std::size_t> level = {node};
+                for (std::size_t height = 0; height < NODE_ORDER_BLOCK_HEIGHT && !level.empty(); height++) {
+                    std::vector<std::size_t> next_level;
+                    for (std::size_t parent : level) {
+                        number_children(parent);
+                        for (std::size_t child = nodes[parent].children_begin_index;
+                             child < nodes[parent].children_end_index; child++)
+                            next_level.push_back(child);
+                    }
+                    level.swap(next_level);
+                }
+
+                for (std::size_t i = level.size(); i-- > 0;)
+                    stack.push(level[i]);
+            }
+        }
+
+        std::vector<NodeType> reordered(num_nodes);
+        for (std::size_t i = 0; i < num_nodes; i++) {
+            NodeType& node = reordered[new_index[i]];
+            node = nodes[i];
+            node.parent = new_index[node.parent];
+            if (node.children_begin_index != node.children_end_index) {
+                // the order within a group of siblings is kept
+                node.children_begin_index = new_index[nodes[i].children_begin_index];
+                node.children_end_index =
+                    node.children_begin_index + (nodes[i].children_end_index - nodes[i].children_begin_index);
+            }
+        }
+        nodes.swap(reordered);
+    }
+
   private:
     std::vector<NodeType> nodes;
     std::size_t num_threads;
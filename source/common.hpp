@@ -2,11 +2,21 @@
 
 #include "implementation/accelerated_levenshtein.hpp"
 #include "implementation/accelerated_levenshtein_sequential.hpp"
+#include "implementation/automaton_levenshtein.hpp"
+#include "implementation/bidirectional_levenshtein.hpp"
+#include "implementation/bit_parallel_levenshtein.hpp"
+#include "implementation/bitmap_sequential_trie.hpp"
+#include "implementation/compact_trie.hpp"
+#include "implementation/louds_trie.hpp"
 #include "implementation/naive_levenshtein.hpp"
+#include "implementation/quantized_levenshtein.hpp"
+#include "implementation/radix_trie.hpp"
 #include "implementation/sequential_levenshtein.hpp"
 #include "implementation/sequential_trie.hpp"
 #include "implementation/sorted_buildup_trie.hpp"
+#include "implementation/streaming_levenshtein.hpp"
 #include "implementation/trie.hpp"
+#include "implementation/utf8_levenshtein.hpp"
 #include "implementation/vectorized_trie.hpp"
 
 #include <string>
@@ -14,9 +24,17 @@
 // NOTATION
 // SEQ: optimized Sequential implementation, PAR: Parallel implementation
 // SORTED: Additional sorting step
-// VT: Vectorized Trie, ST: Sequential Trie, PT: Parallel Trie
-// S: SortedBuildup Trie
+// VT: Vectorized Trie, ST: Sequential Trie, PT: Parallel Trie, RT: Radix Trie, CT: Compact Trie
+// BT: Sequential Trie with Bitmap indexed children, LT: LOUDS (succinct) Trie
+// S: SortedBuildup Trie, D: SortedBuildup Trie built directly from the sorted words
 // NE: No early break
+// BI: Bidirectional (additional trie of the reversed words), H: Heuristic direction choice
+// T: Transpositions of adjacent characters
+// Q8, Q16: Quantized (fixed point) costs in 8 / 16 bit cells
+// BP: Bit-Parallel (unit costs only)
+// DAWG: minimized trie searched with a Levenshtein automaton (unit costs, up to K edits only)
+// UTF8: UTF-8 words as dense symbols of their alphabet (Alphabet, DensePenalty)
+// DFS, BLK: Vectorized Trie with depth first / blocked node order (BFS otherwise)
 
 // ---------- TRIE IMPLEMENTATIONS --------------
 
@@ -28,6 +46,14 @@ struct TRIE_SEQ {
     }
 };
 
+struct TRIE_SEQ_BITMAP {
+    bool seq = true;
+    std::string name = "sequential_bitmap";
+    static auto make([[maybe_unused]] std::size_t num_threads) {
+        return BitmapSequentialTrie<DummyPayload>();
+    }
+};
+
 struct TRIE_PAR {
     bool seq = false;
     std::string name = "parallel";
@@ -44,6 +70,22 @@ struct TRIE_PAR_VECTORIZED {
     }
 };
 
+struct TRIE_PAR_VECTORIZED_DFS {
+    bool seq = false;
+    std::string name = "parallel_vectorized_dfs";
+    static auto make(std::size_t num_threads) {
+        return VectorizedParallelTrie<DummyPayload, true, NodeOrder::DFS>(num_threads);
+    }
+};
+
+struct TRIE_PAR_VECTORIZED_BLOCKED {
+    bool seq = false;
+    std::string name = "parallel_vectorized_blocked";
+    static auto make(std::size_t num_threads) {
+        return VectorizedParallelTrie<DummyPayload, true, NodeOrder::BLOCKED>(num_threads);
+    }
+};
+
 struct TRIE_SEQ_SORTED {
     bool seq = true;
     std::string name = "sorted_buildup_sequential";
@@ -68,8 +110,53 @@ struct TRIE_PAR_VECTORIZED_SORTED {
     }
 };
 
-const auto trie_impls = std::make_tuple(TRIE_SEQ(), TRIE_PAR(), TRIE_PAR_VECTORIZED(), TRIE_SEQ_SORTED(),
-                                        TRIE_PAR_SORTED(), TRIE_PAR_VECTORIZED_SORTED());
+struct TRIE_PAR_VECTORIZED_DIRECT {
+    bool seq = false;
+    std::string name = "direct_sorted_parallel_vectorized";
+    static auto make(std::size_t num_threads) {
+        return SortedBuildupTrie<DummyPayload, VectorizedParallelTrie<DummyPayload, true>, true,
+                                 SortedInsert::SORTED>(num_threads);
+    }
+};
+
+struct TRIE_PAR_VECTORIZED_PARTITIONED {
+    bool seq = false;
+    std::string name = "partitioned_sorted_parallel_vectorized";
+    static auto make(std::size_t num_threads) {
+        return SortedBuildupTrie<DummyPayload, VectorizedParallelTrie<DummyPayload, true>, true,
+                                 SortedInsert::PARTITIONED>(num_threads);
+    }
+};
+
+struct TRIE_RADIX {
+    bool seq = false;
+    std::string name = "radix";
+    static auto make(std::size_t num_threads) {
+        return RadixTrie<DummyPayload, true>(num_threads);
+    }
+};
+
+struct TRIE_PAR_COMPACT {
+    bool seq = false;
+    std::string name = "parallel_compact";
+    static auto make(std::size_t num_threads) {
+        return CompactTrie<DummyPayload, true>(num_threads);
+    }
+};
+
+struct TRIE_LOUDS {
+    bool seq = false;
+    std::string name = "louds";
+    static auto make(std::size_t num_threads) {
+        return LoudsTrie<DummyPayload, true>(num_threads);
+    }
+};
+
+const auto trie_impls =
+    std::make_tuple(TRIE_SEQ(), TRIE_SEQ_BITMAP(), TRIE_PAR(), TRIE_PAR_VECTORIZED(), TRIE_PAR_VECTORIZED_DFS(),
+                    TRIE_PAR_VECTORIZED_BLOCKED(), TRIE_SEQ_SORTED(), TRIE_PAR_SORTED(), TRIE_PAR_VECTORIZED_SORTED(),
+                    TRIE_PAR_VECTORIZED_DIRECT(), TRIE_PAR_VECTORIZED_PARTITIONED(), TRIE_RADIX(), TRIE_PAR_COMPACT(),
+                    TRIE_LOUDS());
 
 // ---------- LEVENSHTEIN IMPLEMENTATIONS --------------
 
@@ -121,6 +208,44 @@ struct LEV_ACCELERATED_VT {
     }
 };
 
+struct LEV_ACCELERATED_VT_DFS {
+    bool seq = false;
+    std::string name = "accelerated_vt_dfs";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return AcceleratedLevenshtein<PenaltyClass, VectorizedParallelTrie<TriePayload, true, NodeOrder::DFS>, true,
+                                      true>(penalty, num_threads);
+    }
+};
+
+struct LEV_ACCELERATED_VT_BLK {
+    bool seq = false;
+    std::string name = "accelerated_vt_blk";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return AcceleratedLevenshtein<PenaltyClass, VectorizedParallelTrie<TriePayload, true, NodeOrder::BLOCKED>,
+                                      true, true>(penalty, num_threads);
+    }
+};
+
+struct LEV_ACCELERATED_RT {
+    bool seq = false;
+    std::string name = "accelerated_rt";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return AcceleratedLevenshtein<PenaltyClass, RadixTrie<TriePayload, true>, true, true>(penalty, num_threads);
+    }
+};
+
+struct LEV_ACCELERATED_CT {
+    bool seq = false;
+    std::string name = "accelerated_ct";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return AcceleratedLevenshtein<PenaltyClass, CompactTrie<TriePayload, true>, true, true>(penalty, num_threads);
+    }
+};
+
 struct LEV_ACCELERATED_VT_NE {
     bool seq = false;
     std::string name = "accelerated_vt_ne";
@@ -140,6 +265,25 @@ struct LEV_ACCELERATED_ST {
     }
 };
 
+struct LEV_ACCELERATED_BT {
+    bool seq = false;
+    std::string name = "accelerated_bt";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return AcceleratedLevenshtein<PenaltyClass, BitmapSequentialTrie<TriePayload>, true, true>(penalty,
+                                                                                                   num_threads);
+    }
+};
+
+struct LEV_ACCELERATED_LT {
+    bool seq = false;
+    std::string name = "accelerated_lt";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return AcceleratedLevenshtein<PenaltyClass, LoudsTrie<TriePayload>, true, true>(penalty, num_threads);
+    }
+};
+
 struct LEV_ACCELERATED_PT {
     bool seq = false;
     std::string name = "accelerated_pt";
@@ -169,6 +313,18 @@ struct LEV_ACCELERATED_VT_S {
     }
 };
 
+struct LEV_ACCELERATED_VT_D {
+    bool seq = false;
+    std::string name = "accelerated_vt_d";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return AcceleratedLevenshtein<
+            PenaltyClass,
+            SortedBuildupTrie<TriePayload, VectorizedParallelTrie<TriePayload, true>, true, SortedInsert::SORTED>, true,
+            true>(penalty, num_threads);
+    }
+};
+
 struct LEV_ACCELERATED_ST_S {
     bool seq = false;
     std::string name = "accelerated_st_s";
@@ -190,20 +346,151 @@ struct LEV_ACCELERATED_PT_S {
     }
 };
 
+struct LEV_ACCELERATED_VT_BI {
+    bool seq = false;
+    std::string name = "accelerated_vt_bi";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return BidirectionalLevenshtein<PenaltyClass, VectorizedParallelTrie<TriePayload, true>, true, true>(
+            penalty, num_threads, SearchDirection::BOTH);
+    }
+};
+
+struct LEV_ACCELERATED_VT_BI_H {
+    bool seq = false;
+    std::string name = "accelerated_vt_bi_h";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return BidirectionalLevenshtein<PenaltyClass, VectorizedParallelTrie<TriePayload, true>, true, true>(
+            penalty, num_threads, SearchDirection::HEURISTIC);
+    }
+};
+
+struct LEV_ACCELERATED_VT_T {
+    bool seq = false;
+    std::string name = "accelerated_vt_t";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return AcceleratedLevenshtein<PenaltyClass, VectorizedParallelTrie<TriePayload, true>, true, true, true>(
+            penalty, num_threads);
+    }
+};
+
+struct LEV_ACCELERATED_PT_T {
+    bool seq = false;
+    std::string name = "accelerated_pt_t";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return AcceleratedLevenshtein<PenaltyClass, ParallelTrie<TriePayload, true>, true, true, true>(penalty,
+                                                                                                     num_threads);
+    }
+};
+
+struct LEV_QUANTIZED_VT_Q16 {
+    bool seq = false;
+    std::string name = "quantized_vt_q16";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return QuantizedLevenshtein<PenaltyClass, std::uint16_t,
+                                    VectorizedParallelTrie<QuantizedTriePayload<std::uint16_t>, true>, true, true>(
+            penalty, num_threads);
+    }
+};
+
+struct LEV_QUANTIZED_VT_Q8 {
+    bool seq = false;
+    std::string name = "quantized_vt_q8";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        return QuantizedLevenshtein<PenaltyClass, std::uint8_t,
+                                    VectorizedParallelTrie<QuantizedTriePayload<std::uint8_t>, true>, true, true>(
+            penalty, num_threads);
+    }
+};
+
+struct LEV_BIT_PARALLEL_VT {
+    bool seq = false;
+    std::string name = "bit_parallel_vt";
+
+    static auto make(std::size_t num_threads, levenshtein::UnitPenalty penalty) {
+        return BitParallelLevenshtein<VectorizedParallelTrie<TriePayload, true>, true, true>(penalty, num_threads);
+    }
+};
+
+struct LEV_BIT_PARALLEL_PT {
+    bool seq = false;
+    std::string name = "bit_parallel_pt";
+
+    static auto make(std::size_t num_threads, levenshtein::UnitPenalty penalty) {
+        return BitParallelLevenshtein<ParallelTrie<TriePayload, true>, true, true>(penalty, num_threads);
+    }
+};
+
+struct LEV_ACCELERATED_VT_UTF8 {
+    bool seq = false;
+    std::string name = "accelerated_vt_utf8";
+
+    template <class PenaltyClass> static auto make(std::size_t num_threads, PenaltyClass penalty) {
+        using DensePenaltyClass = levenshtein::DensePenalty<PenaltyClass>;
+        return Utf8Levenshtein<PenaltyClass,
+                               AcceleratedLevenshtein<DensePenaltyClass, VectorizedParallelTrie<TriePayload, true>,
+                                                      true, true>,
+                               true>(penalty, num_threads);
+    }
+};
+
+struct LEV_AUTOMATON_DAWG_K2 {
+    bool seq = true;
+    std::string name = "automaton_dawg_k2";
+
+    static auto make(std::size_t num_threads, levenshtein::UnitPenalty penalty) {
+        return AutomatonLevenshtein<2, true>(penalty, num_threads);
+    }
+};
+
+struct LEV_AUTOMATON_DAWG_K3 {
+    bool seq = true;
+    std::string name = "automaton_dawg_k3";
+
+    static auto make(std::size_t num_threads, levenshtein::UnitPenalty penalty) {
+        return AutomatonLevenshtein<3, true>(penalty, num_threads);
+    }
+};
+
 const auto all_levenshtein_impls =
     std::make_tuple(LEV_NAIVE_SEQ(), LEV_NAIVE_PAR(), LEV_ACCELERATED_SEQ(), LEV_ACCELERATED_VT(), LEV_ACCELERATED_ST(),
                     LEV_ACCELERATED_PT(), LEV_ACCELERATED_VT_S(), LEV_ACCELERATED_ST_S(), LEV_ACCELERATED_PT_S(),
                     LEV_ACCELERATED_SEQ_NE(), // no early break
-                    LEV_ACCELERATED_PT_NE(), LEV_ACCELERATED_VT_NE());
+                    LEV_ACCELERATED_PT_NE(), LEV_ACCELERATED_VT_NE(), LEV_ACCELERATED_VT_BI(),
+                    LEV_ACCELERATED_VT_BI_H(), LEV_ACCELERATED_RT(), LEV_ACCELERATED_CT(), LEV_ACCELERATED_VT_DFS(),
+                    LEV_ACCELERATED_VT_BLK(), LEV_ACCELERATED_VT_D(), LEV_ACCELERATED_BT(),
+                    LEV_ACCELERATED_LT(), LEV_ACCELERATED_VT_UTF8());
 
 const auto precompute_levenshtein_impls =
     std::make_tuple(LEV_NAIVE_SEQ(), LEV_NAIVE_PAR(), LEV_ACCELERATED_SEQ(), LEV_ACCELERATED_VT(), LEV_ACCELERATED_ST(),
-                    LEV_ACCELERATED_PT(), LEV_ACCELERATED_VT_S(), LEV_ACCELERATED_ST_S(), LEV_ACCELERATED_PT_S());
+                    LEV_ACCELERATED_PT(), LEV_ACCELERATED_VT_S(), LEV_ACCELERATED_ST_S(), LEV_ACCELERATED_PT_S(),
+                    LEV_ACCELERATED_VT_D(), LEV_ACCELERATED_BT(), LEV_ACCELERATED_LT());
 
 const auto query_levenshtein_impls =
     std::make_tuple(LEV_NAIVE_SEQ(), LEV_NAIVE_PAR(), LEV_ACCELERATED_SEQ(), LEV_ACCELERATED_PT(), LEV_ACCELERATED_VT(),
                     LEV_ACCELERATED_SEQ_NE(), // no early break
-                    LEV_ACCELERATED_PT_NE(), LEV_ACCELERATED_VT_NE());
+                    LEV_ACCELERATED_PT_NE(), LEV_ACCELERATED_VT_NE(), LEV_ACCELERATED_VT_BI(),
+                    LEV_ACCELERATED_VT_BI_H(), LEV_ACCELERATED_VT_T(), LEV_QUANTIZED_VT_Q16(), LEV_QUANTIZED_VT_Q8(),
+                    LEV_ACCELERATED_RT(), LEV_ACCELERATED_CT(), LEV_ACCELERATED_VT_DFS(), LEV_ACCELERATED_VT_BLK(),
+                    LEV_ACCELERATED_BT(), LEV_ACCELERATED_LT(), LEV_ACCELERATED_VT_UTF8());
+
+// optimal string alignment distance, not comparable to the implementations above
+const auto transposition_levenshtein_impls = std::make_tuple(LEV_ACCELERATED_VT_T(), LEV_ACCELERATED_PT_T());
+
+// rounded distances, the rankings may deviate from the implementations above
+const auto quantized_levenshtein_impls = std::make_tuple(LEV_QUANTIZED_VT_Q16(), LEV_QUANTIZED_VT_Q8());
+
+// unit costs (levenshtein::UnitPenalty)
+const auto unit_levenshtein_impls =
+    std::make_tuple(LEV_NAIVE_SEQ(), LEV_NAIVE_PAR(), LEV_BIT_PARALLEL_VT(), LEV_BIT_PARALLEL_PT());
+
+// unit costs, only the words within get_max_distance() edits
+const auto bounded_unit_levenshtein_impls = std::make_tuple(LEV_AUTOMATON_DAWG_K2(), LEV_AUTOMATON_DAWG_K3());
 
 // ---------- HELPER ------------
 
@@ -2,10 +2,32 @@
 #include "utils/line_reader.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <random>
+#include <sstream>
+#include <stdexcept>
 #include <vector>
 
+// the engines that compute one dp row per character reject tries with edge runs instead of misreading them
+template <class TrieImpl> concept BitParallelAccepts = requires { typename BitParallelLevenshtein<TrieImpl>; };
+template <class TrieImpl> concept QuantizedAccepts = requires {
+    typename QuantizedLevenshtein<levenshtein::KBDistance, std::uint16_t, TrieImpl>;
+};
+template <class TrieImpl> concept BidirectionalAccepts = requires {
+    typename BidirectionalLevenshtein<levenshtein::KBDistance, TrieImpl>;
+};
+template <class TrieImpl> concept StreamingAccepts = requires {
+    typename StreamingLevenshtein<levenshtein::KBDistance, TrieImpl>;
+};
+
+static_assert(BitParallelAccepts<VectorizedParallelTrie<TriePayload>> && !BitParallelAccepts<RadixTrie<TriePayload>>);
+static_assert(QuantizedAccepts<VectorizedParallelTrie<QuantizedTriePayload<std::uint16_t>>> &&
+              !QuantizedAccepts<RadixTrie<QuantizedTriePayload<std::uint16_t>>>);
+static_assert(BidirectionalAccepts<VectorizedParallelTrie<TriePayload>> &&
+              !BidirectionalAccepts<RadixTrie<TriePayload>>);
+static_assert(StreamingAccepts<VectorizedParallelTrie<DummyPayload>> && !StreamingAccepts<RadixTrie<DummyPayload>>);
+
 int main() {
     const std::string exact_match_test = "Algorithmen";
     const std::string non_exact_match_test = "Akgorighmwn";
@@ -84,5 +106,724 @@ int main() {
         }
     });
 
+    // TEST RESUMABLE QUERY
+    {
+        std::cout << "Testing resumable_query..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+
+        AcceleratedLevenshtein<> lev(penalty);
+        lev.precompute(words);
+
+        auto handle = lev.resumable_query(non_exact_match_test);
+        auto result = handle.next(test_count / 2);
+        auto second_page = handle.next(test_count - test_count / 2);
+        result.insert(result.end(), second_page.begin(), second_page.end());
+
+        if (result.size() != compare_result.size()) {
+            passed = false;
+            reason += "Expected " + std::to_string(compare_result.size()) + " results but got " +
+                      std::to_string(result.size()) + ".";
+        }
+
+        for (std::size_t i = 0; i < std::min(result.size(), compare_result.size()); i++) {
+            if (std::abs(result[i].first - compare_result[i].first) >= 1e-5) {
+                passed = false;
+                reason += "Mismatch at rank " + std::to_string(i) + ": " + result[i].second + ", " +
+                          compare_result[i].second + ".";
+                break;
+            }
+        }
+
+        if (passed)
+            std::cout << "ok" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    }
+
+    // TEST SESSION
+    {
+        std::cout << "Testing session..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+        const std::size_t session_count = 10;
+
+        AcceleratedLevenshtein<> lev(penalty);
+        lev.precompute(words);
+
+        // every word of the reference top-n is within the threshold
+        auto session = lev.session(compare_result[session_count - 1].first + 1e-4f);
+
+        // type with a typo, correct it and finish the word
+        for (char c : non_exact_match_test.substr(0, 4) + "x") {
+            session.push_char(c);
+        }
+        session.pop_char();
+        for (char c : non_exact_match_test.substr(4)) {
+            session.push_char(c);
+        }
+
+        auto result = session.results(session_count);
+
+        if (session.get_query() != non_exact_match_test) {
+            passed = false;
+            reason += "Session query is " + session.get_query() + ".";
+        }
+
+        if (result.size() != session_count) {
+            passed = false;
+            reason += "Expected " + std::to_string(session_count) + " results but got " +
+                      std::to_string(result.size()) + ".";
+        }
+
+        for (std::size_t i = 0; i < std::min(result.size(), session_count); i++) {
+            if (std::abs(result[i].first - compare_result[i].first) >= 1e-5) {
+                passed = false;
+                reason += "Mismatch at rank " + std::to_string(i) + ": " + result[i].second + ", " +
+                          compare_result[i].second + ".";
+                break;
+            }
+        }
+
+        if (passed)
+            std::cout << "ok" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    }
+
+    // TEST PREFIX QUERY
+    {
+        std::cout << "Testing query_prefix..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+        const std::string prefix_test = non_exact_match_test.substr(0, 7);
+        const float completion_penalty = 0.05f;
+
+        // best alignment of the query against any prefix of the word
+        auto prefix_distance = [&](const std::string& word) {
+            std::vector<float> row(prefix_test.size() + 1);
+            row[0] = 0.f;
+            for (std::size_t j = 1; j <= prefix_test.size(); j++)
+                row[j] = row[j - 1] + penalty.remove(prefix_test[j - 1]);
+
+            float best = row.back() + completion_penalty * word.size();
+            for (std::size_t i = 1; i <= word.size(); i++) {
+                float diagonal = row[0];
+                row[0] += penalty.insert(word[i - 1]);
+                for (std::size_t j = 1; j <= prefix_test.size(); j++) {
+                    float next = std::min(std::min(row[j] + penalty.insert(word[i - 1]),
+                                                   row[j - 1] + penalty.remove(prefix_test[j - 1])),
+                                          diagonal + penalty.modify(word[i - 1], prefix_test[j - 1]));
+                    diagonal = row[j];
+                    row[j] = next;
+                }
+                best = std::min(best, row.back() + completion_penalty * (word.size() - i));
+            }
+            return best;
+        };
+
+        std::vector<float> expected;
+        for (auto& word : words)
+            expected.push_back(prefix_distance(word));
+        std::sort(expected.begin(), expected.end());
+
+        AcceleratedLevenshtein<> lev(penalty);
+        lev.precompute(words);
+
+        auto result = lev.query_prefix(prefix_test, test_count, completion_penalty);
+
+        if (result.size() != test_count) {
+            passed = false;
+            reason += "Expected " + std::to_string(test_count) + " results but got " + std::to_string(result.size()) +
+                      ".";
+        }
+
+        for (std::size_t i = 0; i < std::min(result.size(), test_count); i++) {
+            if (std::abs(result[i].first - expected[i]) >= 1e-4 ||
+                std::abs(result[i].first - prefix_distance(result[i].second)) >= 1e-4) {
+                passed = false;
+                reason += "Mismatch at rank " + std::to_string(i) + ": " + result[i].second + ".";
+                break;
+            }
+        }
+
+        if (passed)
+            std::cout << "ok" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    }
+
+    // TEST LATTICE QUERY
+    {
+        std::cout << "Testing query_lattice..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+
+        AcceleratedLevenshtein<> lev(penalty);
+        lev.precompute(words);
+
+        // a lattice with the tapped keys only must behave like the plain query
+        auto result = lev.query_lattice(levenshtein::keyboard_lattice(non_exact_match_test, penalty, 0), test_count);
+
+        for (std::size_t i = 0; i < std::min(result.size(), compare_result.size()); i++) {
+            if (std::abs(result[i].first - compare_result[i].first) >= 1e-5) {
+                passed = false;
+                reason += "Mismatch at rank " + std::to_string(i) + ": " + result[i].second + ", " +
+                          compare_result[i].second + ".";
+                break;
+            }
+        }
+
+        // with the intended keys among the alternatives, the exact word costs only the alternatives
+        auto lattice = levenshtein::keyboard_lattice(non_exact_match_test, penalty, 26);
+        float alternatives_cost = 0.f;
+        for (std::size_t i = 0; i < lattice.size(); i++) {
+            for (const auto& [key, cost] : lattice[i]) {
+                if (key == exact_match_test[i])
+                    alternatives_cost += cost;
+            }
+        }
+
+        result = lev.query_lattice(lattice, test_count);
+
+        if (result.empty() || result[0].second != exact_match_test ||
+            std::abs(result[0].first - alternatives_cost) >= 1e-5) {
+            passed = false;
+            reason += "Exact match was not found.";
+        }
+
+        if (passed)
+            std::cout << "ok" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    }
+
+    // TEST PATTERN QUERY
+    {
+        std::cout << "Testing query_pattern..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+        const std::string pattern = "Alg?rith*";
+
+        std::function<bool(const char*, const char*)> matches = [&](const char* p, const char* w) {
+            if (*p == '\0')
+                return *w == '\0';
+            if (*p == '*')
+                return matches(p + 1, w) || (*w != '\0' && matches(p, w + 1));
+            return *w != '\0' && (*p == '?' || *p == *w) && matches(p + 1, w + 1);
+        };
+
+        std::size_t num_matching = 0;
+        for (auto& word : words) {
+            if (matches(pattern.c_str(), word.c_str()))
+                num_matching++;
+        }
+
+        AcceleratedLevenshtein<> lev(penalty);
+        lev.precompute(words);
+
+        auto result = lev.query_pattern(pattern, test_count);
+
+        std::size_t num_exact = 0;
+        for (auto& entry : result) {
+            if (std::abs(entry.first) < 1e-6) {
+                num_exact++;
+                if (!matches(pattern.c_str(), entry.second.c_str())) {
+                    passed = false;
+                    reason += entry.second + " does not match the pattern.";
+                }
+            }
+        }
+
+        if (num_matching == 0 || num_exact != std::min(num_matching, test_count)) {
+            passed = false;
+            reason += "Expected " + std::to_string(std::min(num_matching, test_count)) + " exact matches but got " +
+                      std::to_string(num_exact) + ".";
+        }
+
+        if (passed)
+            std::cout << "ok" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    }
+
+    // TEST SEGMENTED QUERY
+    {
+        std::cout << "Testing query_segmented..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+
+        AcceleratedLevenshtein<> lev(penalty);
+        lev.precompute(words);
+
+        // a single word is a plain query
+        auto result = lev.query_segmented(non_exact_match_test, test_count, 1);
+
+        for (std::size_t i = 0; i < std::min(result.size(), compare_result.size()); i++) {
+            if (std::abs(result[i].first - compare_result[i].first) >= 1e-5) {
+                passed = false;
+                reason += "Mismatch at rank " + std::to_string(i) + ": " + result[i].second + ", " +
+                          compare_result[i].second + ".";
+                break;
+            }
+        }
+
+        // glued and split by a stray space
+        for (const std::string& query : {exact_match_test + words[0], exact_match_test + " " + words[0]}) {
+            result = lev.query_segmented(query, 10, 2, 0.1f);
+
+            if (result.empty() || std::abs(result[0].first - 0.1f) >= 1e-5 ||
+                result[0].second != exact_match_test + " " + words[0]) {
+                passed = false;
+                reason += "Decomposition of " + query + " was not found.";
+            }
+        }
+
+        if (passed)
+            std::cout << "ok" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    }
+
+    // TEST STREAMING SCAN
+    {
+        std::cout << "Testing StreamingLevenshtein..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+
+        // planted words, one of them with a typo
+        std::string text = "";
+        std::vector<std::size_t> offsets;
+        for (std::size_t i = 0; i < 20; i++) {
+            text += " .. ";
+            offsets.push_back(text.size());
+            text += i == 0 ? non_exact_match_test : words[i];
+        }
+        text += " .. ";
+
+        const float max_cost = 0.5f;
+
+        // chunks much smaller than the words exercise the overlap
+        StreamingLevenshtein<> single(penalty, 1, text.size());
+        StreamingLevenshtein<> chunked(penalty, std::thread::hardware_concurrency(), 16);
+        single.precompute(words);
+        chunked.precompute(words);
+
+        auto expected = single.scan(text, max_cost);
+        std::istringstream stream(text);
+        for (const auto& result : {chunked.scan(text, max_cost), chunked.scan(stream, max_cost, 37)}) {
+            if (result.size() != expected.size()) {
+                passed = false;
+                reason += "Found " + std::to_string(result.size()) + " instead of " +
+                          std::to_string(expected.size()) + " hits.";
+                continue;
+            }
+
+            for (std::size_t i = 0; i < result.size(); i++) {
+                if (result[i].offset != expected[i].offset || result[i].word != expected[i].word ||
+                    std::abs(result[i].cost - expected[i].cost) >= 1e-5) {
+                    passed = false;
+                    reason += "Mismatch at hit " + std::to_string(i) + ": " + result[i].word + ", " +
+                              expected[i].word + ".";
+                    break;
+                }
+            }
+        }
+
+        for (std::size_t i = 1; i < offsets.size(); i++) {
+            if (std::none_of(expected.begin(), expected.end(), [&](const auto& hit) {
+                    return hit.offset == offsets[i] && hit.word == words[i] && hit.cost == 0.f;
+                })) {
+                passed = false;
+                reason += "Missing " + words[i] + " at " + std::to_string(offsets[i]) + ".";
+            }
+        }
+
+        const float typo_cost = seq_lev.query(non_exact_match_test, 1)[0].first;
+        if (std::none_of(expected.begin(), expected.end(), [&](const auto& hit) {
+                return hit.offset == offsets[0] && hit.cost <= typo_cost + 1e-5;
+            })) {
+            passed = false;
+            reason += "Missing correction of " + non_exact_match_test + ".";
+        }
+
+        if (passed)
+            std::cout << "ok" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    }
+
+    // TEST TRANSPOSITIONS
+    {
+        SequentialLevenshtein<levenshtein::KBDistance, true> seq_lev_t(penalty);
+        seq_lev_t.precompute(words);
+
+        // "Algorithmen" with "th" swapped
+        const std::string swapped_test = "Algorihtmen";
+
+        for_each_in_tuple(transposition_levenshtein_impls, [&](const auto& x) {
+            std::cout << "Testing " << x.name << "..." << std::flush;
+            bool passed = true;
+            std::string reason = "";
+
+            auto lev = x.make(std::thread::hardware_concurrency(), penalty);
+            lev.precompute(words);
+
+            for (const std::string& query : {non_exact_match_test, swapped_test}) {
+                auto expected = seq_lev_t.query(query, test_count);
+                auto result = lev.query(query, test_count);
+                std::sort(expected.begin(), expected.end());
+
+                if (result.size() != expected.size()) {
+                    passed = false;
+                    reason += "Size mismatch for " + query + ".";
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < result.size(); i++) {
+                    if (std::abs(result[i].first - expected[i].first) >= 1e-5) {
+                        passed = false;
+                        reason += "Mismatch at rank " + std::to_string(i) + ": " + result[i].second + ", " +
+                                  expected[i].second + ".";
+                        break;
+                    }
+                }
+            }
+
+            auto result = lev.query(swapped_test, 1);
+            if (result.empty() || result[0].second != exact_match_test ||
+                std::abs(result[0].first - penalty.transpose('h', 't')) >= 1e-5) {
+                passed = false;
+                reason += "Swap was not charged as a single transposition.";
+            }
+
+            if (passed)
+                std::cout << "ok" << std::endl;
+            else {
+                std::cout << "FAIL: " << reason << std::endl;
+                all_passed = false;
+            }
+        });
+    }
+
+    // TEST QUANTIZED
+    for_each_in_tuple(quantized_levenshtein_impls, [&](const auto& x) {
+        std::cout << "Testing " << x.name << "..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+
+        auto lev = x.make(std::thread::hardware_concurrency(), penalty);
+        lev.precompute(words);
+
+        auto result = lev.query(non_exact_match_test, test_count);
+        if (result.size() != compare_result.size()) {
+            passed = false;
+            reason += "Size mismatch.";
+        }
+
+        // the rounding error accumulates along the alignment
+        float max_deviation = 0;
+        for (const auto& [distance, word] : result) {
+            const float exact = seq_lev.edit_distance(word, non_exact_match_test);
+            const float bound = (word.size() + non_exact_match_test.size()) * 0.5f / lev.get_scale();
+
+            max_deviation = std::max(max_deviation, std::abs(distance - exact));
+            if (std::abs(distance - exact) > bound + 1e-5) {
+                passed = false;
+                reason += "Distance of " + word + " is off by more than " + std::to_string(bound) + ".";
+            }
+        }
+
+        std::size_t common = 0;
+        for (const auto& entry : result) {
+            common += std::any_of(compare_result.begin(), compare_result.end(),
+                                  [&](const auto& compare) { return compare.second == entry.second; });
+        }
+
+        if (passed)
+            std::cout << "ok (" << common << "/" << compare_result.size() << " words in common, max deviation "
+                      << max_deviation << ")" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    });
+
+    // TEST UNIT COSTS
+    {
+        levenshtein::UnitPenalty unit_penalty;
+        SequentialLevenshtein<levenshtein::UnitPenalty> seq_lev_unit(unit_penalty);
+        seq_lev_unit.precompute(words);
+
+        // longer than a machine word
+        std::string long_query = "";
+        for (std::size_t i = 0; long_query.size() <= 100; i++) {
+            long_query += words[i];
+        }
+
+        std::vector<std::pair<std::string, std::vector<std::pair<float, std::string>>>> expected;
+        // one edit away from a word
+        const std::string close_query = "Algoritmen";
+
+        for (const std::string& query : {non_exact_match_test, long_query, std::string(""), close_query}) {
+            expected.emplace_back(query, seq_lev_unit.query(query, test_count));
+            std::sort(expected.back().second.begin(), expected.back().second.end());
+        }
+
+        for_each_in_tuple(unit_levenshtein_impls, [&](const auto& x) {
+            std::cout << "Testing " << x.name << " (unit costs)..." << std::flush;
+            bool passed = true;
+            std::string reason = "";
+
+            auto lev = x.make(std::thread::hardware_concurrency(), unit_penalty);
+            lev.precompute(words);
+
+            for (const auto& [query, compare] : expected) {
+                auto result = lev.query(query, test_count);
+
+                if (result.size() != compare.size()) {
+                    passed = false;
+                    reason += "Size mismatch for " + query + ".";
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < result.size(); i++) {
+                    if (result[i].first != compare[i].first) {
+                        passed = false;
+                        reason += "Mismatch at rank " + std::to_string(i) + ": " + result[i].second + ", " +
+                                  compare[i].second + ".";
+                        break;
+                    }
+                }
+            }
+
+            if (passed)
+                std::cout << "ok" << std::endl;
+            else {
+                std::cout << "FAIL: " << reason << std::endl;
+                all_passed = false;
+            }
+        });
+
+        // the expected words within the bound
+        for_each_in_tuple(bounded_unit_levenshtein_impls, [&](const auto& x) {
+            std::cout << "Testing " << x.name << " (unit costs)..." << std::flush;
+            bool passed = true;
+            std::string reason = "";
+
+            auto lev = x.make(std::thread::hardware_concurrency(), unit_penalty);
+            lev.precompute(words);
+
+            for (const auto& [query, compare] : expected) {
+                auto result = lev.query(query, test_count);
+
+                std::vector<std::pair<float, std::string>> bounded;
+                for (const auto& entry : compare) {
+                    if (entry.first <= lev.get_max_distance())
+                        bounded.push_back(entry);
+                }
+
+                if (result.size() != bounded.size()) {
+                    passed = false;
+                    reason += "Size mismatch for " + query + ".";
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < result.size(); i++) {
+                    if (result[i].first != bounded[i].first ||
+                        seq_lev_unit.edit_distance(result[i].second, query) != result[i].first) {
+                        passed = false;
+                        reason += "Mismatch at rank " + std::to_string(i) + ": " + result[i].second + ", " +
+                                  bounded[i].second + ".";
+                        break;
+                    }
+                }
+            }
+
+            if (passed)
+                std::cout << "ok" << std::endl;
+            else {
+                std::cout << "FAIL: " << reason << std::endl;
+                all_passed = false;
+            }
+        });
+    }
+
+    // TEST UTF-8
+    {
+        std::cout << "Testing utf8 alphabet..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+
+        // the words with their umlauts ("Maedchen" -> "M\u00e4dchen")
+        std::vector<std::string> utf8_words = words;
+        for (const std::string& word : words) {
+            std::string umlauts = word;
+            for (const auto& [from, to] : {std::pair<std::string, std::string>("ae", "\u00e4"), {"oe", "\u00f6"},
+                                           {"ue", "\u00fc"}}) {
+                for (std::size_t position; (position = umlauts.find(from)) != std::string::npos;)
+                    umlauts.replace(position, from.size(), to);
+            }
+            if (umlauts != word)
+                utf8_words.push_back(umlauts);
+        }
+        const std::string umlaut_word = utf8_words.back();
+
+        Utf8Levenshtein<levenshtein::KBDistance,
+                        AcceleratedLevenshtein<levenshtein::DensePenalty<levenshtein::KBDistance>>>
+            lev(penalty);
+        lev.precompute(utf8_words);
+
+        for (const std::string& word : utf8_words) {
+            if (lev.get_alphabet().decode(lev.get_alphabet().encode(word)) != word) {
+                passed = false;
+                reason += "Encoding of " + word + " is not reversible.";
+                break;
+            }
+        }
+
+        auto result = lev.query(umlaut_word, test_count);
+        if (result.empty() || result[0].second != umlaut_word || std::abs(result[0].first) >= 1e-6) {
+            passed = false;
+            reason += "Exact match of " + umlaut_word + " was not found.";
+        }
+
+        // a code point that is not in the dictionary matches no symbol
+        result = lev.query(umlaut_word + "\u20ac", test_count);
+        if (result.size() != test_count || std::abs(result[0].first) < 1e-6) {
+            passed = false;
+            reason += "A query with an unknown character must have no exact match.";
+        }
+
+        // bytes outside the alphabet cost as much as the unknown symbol
+        const levenshtein::DensePenalty<levenshtein::KBDistance> dense(penalty, lev.get_alphabet());
+        const char unknown = lev.get_alphabet().get_unknown();
+        if (dense.remove('\xff') != dense.remove(unknown) || dense.modify('a', '\x7f') != dense.modify('a', unknown)) {
+            passed = false;
+            reason += "Symbols outside the alphabet must be charged like the unknown symbol.";
+        }
+
+        // more distinct code points than symbols (Cyrillic and Greek letters)
+        std::vector<std::string> large_alphabet_words;
+        for (char32_t code_point = 0x391; code_point < 0x391 + 2 * Alphabet::MAX_SIZE; code_point += 2) {
+            std::string word;
+            utf8::append(word, code_point);
+            utf8::append(word, code_point + 1);
+            large_alphabet_words.push_back(word);
+        }
+        try {
+            Utf8Levenshtein<levenshtein::KBDistance,
+                            AcceleratedLevenshtein<levenshtein::DensePenalty<levenshtein::KBDistance>>>
+                large_lev(penalty);
+            large_lev.precompute(large_alphabet_words);
+            passed = false;
+            reason += "An alphabet with more than " + std::to_string(Alphabet::MAX_SIZE) + " symbols was accepted.";
+        } catch (const std::length_error&) {
+        }
+
+        if (passed)
+            std::cout << "ok (" << lev.get_alphabet().size() << " symbols)" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    }
+
+    // TEST CPU DISPATCH
+    {
+        const cpu_dispatch::Isa detected = cpu_dispatch::selected();
+
+        for (cpu_dispatch::Isa isa : {cpu_dispatch::Isa::SSE42, cpu_dispatch::Isa::AVX2, cpu_dispatch::Isa::AVX512}) {
+            if (cpu_dispatch::force(isa) != isa)
+                continue;
+
+            std::cout << "Testing " << cpu_dispatch::to_string(isa) << " kernels..." << std::flush;
+            bool passed = true;
+            std::string reason = "";
+
+            AcceleratedLevenshtein<> lev(penalty);
+            lev.precompute(words);
+            auto result = lev.query(non_exact_match_test, test_count);
+
+            NaiveLevenshtein<> naive_lev(penalty);
+            naive_lev.precompute(words);
+            auto naive_result = naive_lev.query(non_exact_match_test, test_count);
+
+            for (const auto& r : {result, naive_result}) {
+                for (std::size_t i = 0; i < std::min(r.size(), compare_result.size()); i++) {
+                    if (std::abs(r[i].first - compare_result[i].first) >= 1e-5) {
+                        passed = false;
+                        reason += "Mismatch at rank " + std::to_string(i) + ": " + r[i].second + ", " +
+                                  compare_result[i].second + ".";
+                        break;
+                    }
+                }
+            }
+
+            if (passed)
+                std::cout << "ok" << std::endl;
+            else {
+                std::cout << "FAIL: " << reason << std::endl;
+                all_passed = false;
+            }
+        }
+
+        cpu_dispatch::force(detected);
+    }
+
+    // TEST EDIT SCRIPTS
+    {
+        std::cout << "Testing explain..." << std::flush;
+        bool passed = true;
+        std::string reason = "";
+
+        AcceleratedLevenshtein<> lev(penalty);
+        lev.precompute(words);
+
+        auto result = lev.query(non_exact_match_test, test_count);
+        auto scripts = lev.explain(non_exact_match_test, result);
+
+        for (std::size_t i = 0; i < result.size(); i++) {
+            // replaying the script yields the word and the query
+            std::string word = "";
+            std::string query = "";
+            float cost = 0;
+            for (const auto& edit : scripts[i].edits) {
+                if (edit.type != levenshtein::EditType::REMOVE)
+                    word += edit.word_character;
+                if (edit.type != levenshtein::EditType::INSERT)
+                    query += edit.query_character;
+                cost += edit.cost;
+            }
+
+            if (word != result[i].second || query != non_exact_match_test ||
+                std::abs(scripts[i].cost - result[i].first) >= 1e-4 || std::abs(cost - scripts[i].cost) >= 1e-5) {
+                passed = false;
+                reason += "Invalid script for " + result[i].second + ".";
+            }
+        }
+
+        if (passed)
+            std::cout << "ok" << std::endl;
+        else {
+            std::cout << "FAIL: " << reason << std::endl;
+            all_passed = false;
+        }
+    }
+
     return !all_passed;
 }
\ No newline at end of file
@@ -23,7 +23,8 @@ int main() {
 
             auto current = trie.get_root();
 
-            for (char c : word) {
+            for (std::size_t i = 0; i < word.size();) {
+                const char c = word[i];
 
                 auto child_iters = trie.get_child_iterator(current);
                 auto next = child_iters.second;
@@ -41,6 +42,20 @@ int main() {
                 }
 
                 current = trie.dereference_child_iterator(next);
+
+                // the edge holds a run of characters
+                if constexpr (EdgeTrie<decltype(trie)>) {
+                    auto [run, length] = trie.get_edge(current);
+
+                    if (word.compare(i, length, run, length) != 0) {
+                        passed = false;
+                        all_passed = false;
+                        break;
+                    }
+                    i += length;
+                } else {
+                    i++;
+                }
             }
 
             if (!trie.is_leaf(current)) {
@@ -57,6 +72,83 @@ int main() {
         }
     });
 
+    {
+        std::cout << "Testing insert_sorted and insert_partitioned against insert..." << std::flush;
+        bool passed = true;
+
+        LineReader reader("../data/german_words.txt");
+        std::vector<std::string> words = reader.read();
+        words.push_back("");
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        VectorizedParallelTrie<DummyPayload> expected(std::thread::hardware_concurrency());
+        expected.insert(words);
+        VectorizedParallelTrie<DummyPayload> trie(std::thread::hardware_concurrency());
+        trie.insert_sorted(words);
+
+        passed = expected.get_num_nodes() == trie.get_num_nodes();
+        for (std::size_t node = 0; passed && node < trie.get_num_nodes(); node++) {
+            passed = expected.is_leaf(node) == trie.is_leaf(node) &&
+                     expected.get_parent(node) == trie.get_parent(node) &&
+                     expected.get_character(node) == trie.get_character(node) &&
+                     expected.get_child_iterator(node) == trie.get_child_iterator(node);
+        }
+
+        // numbered breadth first per partition, the words of the leaves must match
+        VectorizedParallelTrie<DummyPayload> partitioned(std::thread::hardware_concurrency());
+        partitioned.insert_partitioned(words);
+
+        std::vector<std::string> leaf_words;
+        for (std::size_t node = 0; passed && node < partitioned.get_num_nodes(); node++) {
+            if (partitioned.is_leaf(node))
+                leaf_words.push_back(node ? partitioned.get_word(node) : "");
+        }
+        std::sort(leaf_words.begin(), leaf_words.end());
+        passed = passed && partitioned.get_num_nodes() == expected.get_num_nodes() && leaf_words == words;
+
+        if (passed) {
+            std::cout << "passed" << std::endl;
+        } else {
+            std::cout << "FAIL" << std::endl;
+            all_passed = false;
+        }
+    }
+
+    {
+        std::cout << "Testing louds against insert_sorted..." << std::flush;
+        bool passed = true;
+
+        LineReader reader("../data/german_words.txt");
+        std::vector<std::string> words = reader.read();
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        // both are numbered breadth first with sorted children
+        VectorizedParallelTrie<DummyPayload> expected(std::thread::hardware_concurrency());
+        expected.insert_sorted(words);
+        LoudsTrie<DummyPayload> trie(std::thread::hardware_concurrency());
+        trie.insert_sorted(words);
+
+        passed = expected.get_num_nodes() == trie.get_num_nodes();
+        for (std::size_t node = 0; passed && node < trie.get_num_nodes(); node++) {
+            const auto [expected_begin, expected_end] = expected.get_child_iterator(node);
+            const auto [begin, end] = trie.get_child_iterator(node);
+
+            passed = expected.is_leaf(node) == trie.is_leaf(node) &&
+                     expected.get_parent(node) == trie.get_parent(node) &&
+                     expected.get_character(node) == trie.get_character(node) &&
+                     expected_end - expected_begin == end - begin && (begin == end || expected_begin == begin);
+        }
+
+        if (passed) {
+            std::cout << "passed" << std::endl;
+        } else {
+            std::cout << "FAIL" << std::endl;
+            all_passed = false;
+        }
+    }
+
     if (all_passed)
         return 0;
     return 1;
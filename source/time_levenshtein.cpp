@@ -35,6 +35,18 @@ int main(int argn, char** argc) {
         return 1;
     }
 
+    // force the instruction set of the kernels (sse4.2, avx2, avx512), by default the best supported one is used
+    std::string isa_name = cl.strArg("-isa", "");
+    cpu_dispatch::Isa isa;
+    if (!isa_name.empty()) {
+        if (!cpu_dispatch::parse(isa_name, isa)) {
+            std::cout << "unknown isa" << std::endl;
+            return 1;
+        }
+        cpu_dispatch::force(isa);
+    }
+    std::cout << "Using " << cpu_dispatch::to_string(cpu_dispatch::selected()) << " kernels" << std::endl;
+
     std::ofstream file(output);
 
     print(file, "index", 5);
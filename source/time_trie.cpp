@@ -1,5 +1,6 @@
 #include "utils/commandline.h"
 #include "utils/line_reader.hpp"
+#include "utils/memory_usage.hpp"
 #include "utils/statistics_collector.hpp"
 #include "utils/string_utils.hpp"
 
@@ -122,6 +123,9 @@ int main(int argn, char** argc) {
 
                     // ADD TESTS
                     tests.push_back({[&]([[maybe_unused]] std::size_t threads) {
+                                         reset_peak_rss();
+                                         const std::size_t rss_before = current_rss();
+
                                          statistics_collector::get().start_measure("total");
 
                                          statistics_collector::get().start_measure("construct");
@@ -133,9 +137,23 @@ int main(int argn, char** argc) {
                                          statistics_collector::get().stop_measure();
 
                                          statistics_collector::get().stop_measure();
+
+                                         // peak memory of the build above the memory before
+                                         statistics_collector::get().add_stat(
+                                             "peak_rss_bytes", std::to_string(peak_rss() - rss_before));
                                      },
                                      true, "t_insert"});
 
+                    tests.push_back({[&](std::size_t threads) {
+                                         auto* owned_trie = new auto(x.make(threads));
+                                         owned_trie->insert(partition);
+
+                                         statistics_collector::get().start_measure("total");
+                                         delete owned_trie;
+                                         statistics_collector::get().stop_measure();
+                                     },
+                                     true, "t_teardown"});
+
                     auto trie = x.make(std::thread::hardware_concurrency());
                     trie.insert(partition);
 
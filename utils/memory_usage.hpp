@@ -0,0 +1,34 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+// Resident set size of the process from /proc/self/status (Linux), 0 if it is not available.
+
+// value of a "Vm...:" line in kB
+inline std::size_t read_status_kb(const std::string& key) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, key.size(), key) == 0 && line.size() > key.size() && line[key.size()] == ':')
+            return std::stoul(line.substr(key.size() + 1));
+    }
+    return 0;
+}
+
+// bytes
+inline std::size_t current_rss() {
+    return read_status_kb("VmRSS") * 1024;
+}
+
+// highest resident set size since the start or the last reset_peak_rss, bytes
+inline std::size_t peak_rss() {
+    return read_status_kb("VmHWM") * 1024;
+}
+
+// sets the peak to the current resident set size, returns false if the kernel does not support it
+inline bool reset_peak_rss() {
+    std::ofstream out("/proc/self/clear_refs");
+    out << "5";
+    return static_cast<bool>(out.flush());
+}